@@ -28,6 +28,9 @@ Benchmark::Benchmark(benchmark::Cores &&cores, const std::uint16_t iterations, s
         this->_chronometer.add(benchmark::Perf::SW_PREFETCH_ACCESS_WRITE);
     }
 
+    // Task statistics are only recorded when they are written.
+    mx::tasking::diagnostics::enable_statistics(this->_statistic_file_name.empty() == false);
+
     std::cout << "core configuration: \n" << this->_cores.dump(2) << std::endl;
 
     this->_workload.build(fill_workload_file, mixed_workload_file);
@@ -122,7 +125,7 @@ void Benchmark::requests_finished()
         }
 
         // Dump statistics to file.
-        if constexpr (mx::tasking::config::task_statistics())
+        if (mx::tasking::diagnostics::is_statistics_enabled())
         {
             if (this->_statistic_file_name.empty() == false)
             {
@@ -5,11 +5,13 @@
 #include <atomic>
 #include <benchmark/workload.h>
 #include <cstdint>
+#include <cstdlib>
 #include <db/index/blinktree/b_link_tree.h>
 #include <db/index/blinktree/config.h>
 #include <db/index/blinktree/insert_value_task.h>
 #include <db/index/blinktree/lookup_task.h>
 #include <db/index/blinktree/update_task.h>
+#include <iostream>
 #include <mx/resource/resource.h>
 #include <mx/tasking/runtime.h>
 #include <mx/tasking/task.h>
@@ -187,6 +189,11 @@ public:
         const auto container = mx::tasking::runtime::new_resource<RequestContainer>(
             sizeof(RequestContainer), mx::resource::hint{channel_id}, core_id,
             config::max_parallel_requests() / core_set.size(), workload);
+        if (container == nullptr)
+        {
+            std::cerr << "Could not allocate the request container: memory limit reached." << std::endl;
+            std::abort();
+        }
         this->annotate(container, sizeof(RequestContainer));
     }
 
@@ -228,7 +235,7 @@ public:
                 }
 
                 task->annotate(_tree->root(), db::index::blinktree::config::node_size() / 4U);
-                mx::tasking::runtime::spawn(*task, channel_id);
+                mx::tasking::runtime::spawn_batch(*task, channel_id);
             }
         }
         else if (next_requests.is_finished())
@@ -3,6 +3,8 @@
 #include "inline_hashtable.h"
 #include "partition_task.h"
 #include "tpch_table_reader.h"
+#include <cstdlib>
+#include <iostream>
 #include <mx/memory/global_heap.h>
 #include <mx/tasking/runtime.h>
 
@@ -68,11 +70,10 @@ void Benchmark::start()
 
     this->_merge_task = std::make_unique<MergeTask>(this->_cores.current(), this, count_right_keys_per_core);
 
-    // Clear notifications.
-    this->_build_notification = BuildFinishedNotifier{count_cores};
-    this->_probe_notification = ProbeFinishedNotifier{this->_merge_task.get()};
-    this->_build_listener = std::make_unique<Listener<BuildFinishedNotifier>>(count_cores, this->_build_notification);
-    this->_probe_listener = std::make_unique<Listener<ProbeFinishedNotifier>>(count_cores, this->_probe_notification);
+    // The build phase waits for the partition tasks, which register their build tasks.
+    // The probe phase is joined by the merge task, likewise.
+    this->_build_finished_task = std::make_unique<BuildFinishedNotifier>(count_cores);
+    this->_build_join_counter.reset(count_cores, this->_build_finished_task.get());
 
     // Build hash_tables.
     this->_hash_tables.reset(new mx::resource::ptr[count_cores]); // NOLINT
@@ -87,6 +88,11 @@ void Benchmark::start()
                 mx::resource::hint{std::uint16_t(channel_id), mx::synchronization::isolation_level::Exclusive,
                                    mx::synchronization::protocol::Queue},
                 needed_bytes);
+        if (this->_hash_tables.get()[channel_id] == nullptr)
+        {
+            std::cerr << "Could not allocate the hash table: memory limit reached." << std::endl;
+            std::abort();
+        }
     }
 
     /// Dispatch left table
@@ -113,13 +119,13 @@ void Benchmark::start()
 
         // Run dispatcher task.
         auto *partition_probe_task = mx::tasking::runtime::new_task<PartitionTask<ProbeTask>>(
-            0U, *this->_probe_listener, this->_batches[this->_current_batch_index], count_right_keys_for_core,
+            0U, *this->_merge_task, this->_batches[this->_current_batch_index], count_right_keys_for_core,
             this->_hash_tables.get());
         partition_probe_task->annotate(right_chunk, 64U);
-        this->_build_notification.dispatch_probe_task(i, partition_probe_task);
+        this->_build_finished_task->dispatch_probe_task(i, partition_probe_task);
 
         auto *partition_build_task = mx::tasking::runtime::new_task<PartitionTask<BuildTask>>(
-            0U, *this->_build_listener, this->_batches[this->_current_batch_index], count_left_keys_for_core,
+            0U, this->_build_join_counter, this->_batches[this->_current_batch_index], count_left_keys_for_core,
             this->_hash_tables.get());
         partition_build_task->annotate(left_chunk, 64U);
         partition_build_tasks[i] = partition_build_task;
@@ -1,12 +1,12 @@
 #pragma once
 
-#include "listener.h"
 #include "merge_task.h"
 #include "notifier.h"
 #include <benchmark/chronometer.h>
 #include <benchmark/cores.h>
 #include <cstdint>
 #include <memory>
+#include <mx/tasking/join_counter.h>
 #include <string>
 #include <tuple>
 
@@ -53,13 +53,12 @@ private:
 
     std::unique_ptr<mx::resource::ptr> _hash_tables;
 
-    std::unique_ptr<Listener<BuildFinishedNotifier>> _build_listener;
-    std::unique_ptr<Listener<ProbeFinishedNotifier>> _probe_listener;
-
     std::unique_ptr<MergeTask> _merge_task;
 
-    alignas(64) BuildFinishedNotifier _build_notification;
-    ProbeFinishedNotifier _probe_notification;
+    std::unique_ptr<BuildFinishedNotifier> _build_finished_task;
+
+    // Counter joining the tasks of the build phase.
+    alignas(64) mx::tasking::JoinCounter _build_join_counter;
 
     // Chronometer for starting/stopping time and performance counter.
     alignas(64) benchmark::Chronometer<std::uint32_t> _chronometer;
@@ -2,6 +2,7 @@
 #include "inline_hashtable.h"
 #include <cstdint>
 #include <iostream>
+#include <mx/tasking/join_counter.h>
 #include <mx/tasking/task.h>
 #include <vector>
 
@@ -12,7 +13,11 @@ namespace application::hash_join {
 class BuildTask final : public mx::tasking::TaskInterface
 {
 public:
-    BuildTask(const std::size_t size, const std::uint8_t /*numa_node_id*/) { _keys.reserve(size); }
+    BuildTask(mx::tasking::JoinCounter &join_counter, const std::size_t size, const std::uint8_t /*numa_node_id*/)
+        : _join_counter(join_counter)
+    {
+        _keys.reserve(size);
+    }
     ~BuildTask() override = default;
 
     mx::tasking::TaskResult execute(const std::uint16_t /*core_id*/, const std::uint16_t /*channel_id*/) override
@@ -24,7 +29,8 @@ public:
             hashtable->insert(std::get<1>(row), std::get<0>(row));
         }
 
-        return mx::tasking::TaskResult::make_remove();
+        // Start the probe phase after the last task of the build phase.
+        return mx::tasking::TaskResult::make_succeed_and_remove(_join_counter.arrive());
     }
 
     void emplace_back(const std::size_t row_id, const std::uint32_t key) noexcept
@@ -36,6 +42,9 @@ public:
     [[nodiscard]] bool empty() const noexcept { return _keys.empty(); }
 
 private:
+    // Counter to arrive at when the keys are inserted.
+    mx::tasking::JoinCounter &_join_counter;
+
     // Keys and row ids to insert into the hashtable.
     std::vector<std::pair<std::size_t, std::uint32_t>> _keys;
 };
@@ -4,7 +4,7 @@
 using namespace application::hash_join;
 
 MergeTask::MergeTask(const mx::util::core_set &cores, Benchmark *benchmark, const std::uint64_t output_per_core)
-    : _benchmark(benchmark), _count_cores(cores.size())
+    : _benchmark(benchmark), _count_cores(cores.size()), _join_counter(cores.size(), this)
 {
     this->_result_sets = new mx::util::aligned_t<mx::util::vector<std::pair<std::size_t, std::size_t>>>[cores.size()];
 
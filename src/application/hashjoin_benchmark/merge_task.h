@@ -3,6 +3,7 @@
 #include <array>
 #include <functional>
 #include <mx/memory/global_heap.h>
+#include <mx/tasking/join_counter.h>
 #include <mx/tasking/task.h>
 #include <mx/util/aligned_t.h>
 #include <mx/util/core_set.h>
@@ -32,10 +33,16 @@ public:
 
     [[nodiscard]] std::size_t count_tuples() const noexcept { return _count_output_tuples; }
 
+    /**
+     * @return Counter joining all tasks of the probe phase; the merge task is its continuation.
+     */
+    mx::tasking::JoinCounter &join_counter() noexcept { return _join_counter; }
+
 private:
     Benchmark *_benchmark;
     const std::uint16_t _count_cores;
     std::size_t _count_output_tuples{0U};
     mx::util::aligned_t<mx::util::vector<std::pair<std::size_t, std::size_t>>> *_result_sets;
+    alignas(64) mx::tasking::JoinCounter _join_counter;
 };
 } // namespace application::hash_join
\ No newline at end of file
@@ -1,56 +1,35 @@
 #pragma once
 
-#include "merge_task.h"
 #include <array>
+#include <cstdint>
+#include <mx/tasking/config.h>
 #include <mx/tasking/task.h>
-#include <mx/util/vector.h>
 
 namespace application::hash_join {
-
-class BuildFinishedNotifier
+/**
+ * Continuation of the build phase: Dispatches the partition
+ * tasks of the probe side once all hash tables are built.
+ */
+class BuildFinishedNotifier final : public mx::tasking::TaskInterface
 {
 public:
-    constexpr BuildFinishedNotifier() = default;
-    constexpr BuildFinishedNotifier(const std::uint16_t count_cores) : _count_cores(count_cores)
+    explicit BuildFinishedNotifier(const std::uint16_t count_cores) : _count_cores(count_cores)
     {
         _probe_tasks.fill(nullptr);
     }
 
-    BuildFinishedNotifier &operator=(BuildFinishedNotifier &&) = default;
-
-    ~BuildFinishedNotifier() = default;
+    ~BuildFinishedNotifier() override = default;
 
     void dispatch_probe_task(const std::uint16_t index, mx::tasking::TaskInterface *task) noexcept
     {
         _probe_tasks[index] = task;
     }
 
-    void operator()(std::uint16_t channel_id);
+    mx::tasking::TaskResult execute(std::uint16_t core_id, std::uint16_t channel_id) override;
 
 private:
-    std::uint16_t _count_cores{0U};
+    const std::uint16_t _count_cores;
     std::array<mx::tasking::TaskInterface *, mx::tasking::config::max_cores()> _probe_tasks{};
 };
 
-class ProbeFinishedNotifier
-{
-public:
-    constexpr ProbeFinishedNotifier() = default;
-    constexpr ProbeFinishedNotifier(MergeTask *merge_task) : _merge_task(merge_task) {}
-
-    ProbeFinishedNotifier &operator=(ProbeFinishedNotifier &&) = default;
-
-    ~ProbeFinishedNotifier() = default;
-
-    void operator()(std::uint16_t channel_id);
-
-    mx::util::vector<std::pair<std::size_t, std::size_t>> &result_set(const std::uint16_t channel_id) noexcept
-    {
-        return _merge_task->result_set(channel_id);
-    }
-
-private:
-    MergeTask *_merge_task{nullptr};
-};
-
 } // namespace application::hash_join
\ No newline at end of file
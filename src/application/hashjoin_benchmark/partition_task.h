@@ -1,37 +1,44 @@
 #pragma once
 #include "build_task.h"
-#include "listener.h"
-#include "notification_task.h"
-#include "notifier.h"
+#include "merge_task.h"
 #include "probe_task.h"
 #include <array>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <iostream>
+#include <mx/tasking/join_counter.h>
 #include <mx/tasking/runtime.h>
 #include <mx/tasking/task.h>
-#include <mx/util/core_set.h>
 #include <vector>
 
 namespace application::hash_join {
 
-template <class T> struct notifier_type
+/**
+ * Build tasks arrive at the join counter of the build phase directly,
+ * probe tasks at the join counter of the merge task.
+ */
+template <class T> struct joined_by_type
 {
-    using value = BuildFinishedNotifier;
+    using value = mx::tasking::JoinCounter;
 };
 
-template <> struct notifier_type<ProbeTask>
+template <> struct joined_by_type<ProbeTask>
 {
-    using value = ProbeFinishedNotifier;
+    using value = MergeTask;
 };
 
+/**
+ * The partition task distributes the keys of a chunk to build or probe
+ * tasks of all cores. Every spawned build/probe task is a predecessor of
+ * the join counter, which starts the next phase after all tasks finished.
+ */
 template <typename T> class PartitionTask final : public mx::tasking::TaskInterface
 {
 public:
-    constexpr PartitionTask(Listener<typename notifier_type<T>::value> &listener, const std::uint32_t batch_size,
+    constexpr PartitionTask(typename joined_by_type<T>::value &joined_by, const std::uint32_t batch_size,
                             const std::size_t count, const mx::resource::ptr *hash_tables) noexcept
-        : _listener(listener), _batch_size(batch_size), _count(count), _hash_tables(hash_tables)
+        : _joined_by(joined_by), _batch_size(batch_size), _count(count), _hash_tables(hash_tables)
     {
     }
 
@@ -39,24 +46,12 @@ public:
 
     mx::tasking::TaskResult execute(const std::uint16_t core_id, const std::uint16_t channel_id) override
     {
-        const auto count_cores = _listener.count_cores();
+        const auto count_cores = mx::tasking::runtime::channels();
 
         auto build_probe_tasks = std::array<T *, mx::tasking::config::max_cores()>{nullptr};
         for (auto target_channel_id = 0U; target_channel_id < count_cores; ++target_channel_id)
         {
-            if constexpr (std::is_same<T, BuildTask>::value)
-            {
-                build_probe_tasks[target_channel_id] = mx::tasking::runtime::new_task<T>(
-                    core_id, _batch_size, mx::tasking::runtime::numa_node_id(target_channel_id));
-            }
-            else
-            {
-                build_probe_tasks[target_channel_id] = mx::tasking::runtime::new_task<T>(
-                    core_id, _listener.notificator().result_set(target_channel_id), _batch_size,
-                    mx::tasking::runtime::numa_node_id(target_channel_id));
-            }
-
-            build_probe_tasks[target_channel_id]->annotate(_hash_tables[target_channel_id], 64U);
+            build_probe_tasks[target_channel_id] = this->new_build_probe_task(core_id, target_channel_id);
         }
 
         auto *data = this->annotated_resource().template get<std::uint32_t>();
@@ -72,46 +67,59 @@ public:
             // Run specific task and create new.
             if (build_probe_tasks[target_channel_id]->size() == _batch_size)
             {
-                mx::tasking::runtime::spawn(*build_probe_tasks[target_channel_id], channel_id);
-
-                if constexpr (std::is_same<T, BuildTask>::value)
-                {
-                    build_probe_tasks[target_channel_id] = mx::tasking::runtime::new_task<T>(
-                        core_id, _batch_size, mx::tasking::runtime::numa_node_id(target_channel_id));
-                }
-                else
-                {
-                    build_probe_tasks[target_channel_id] = mx::tasking::runtime::new_task<T>(
-                        core_id, _listener.notificator().result_set(target_channel_id), _batch_size,
-                        mx::tasking::runtime::numa_node_id(target_channel_id));
-                }
-
-                build_probe_tasks[target_channel_id]->annotate(_hash_tables[target_channel_id], 64U);
+                mx::tasking::runtime::spawn_batch(*build_probe_tasks[target_channel_id], channel_id);
+                build_probe_tasks[target_channel_id] = this->new_build_probe_task(core_id, target_channel_id);
             }
         }
 
         for (auto target_channel_id = 0U; target_channel_id < count_cores; ++target_channel_id)
         {
             // Run last build/probe tasks that are not "full".
-            mx::tasking::runtime::spawn(*build_probe_tasks[target_channel_id], channel_id);
-
-            // Run notification tasks for every core, indicating that all
-            // build/probe tasks of this core are dispatched.
-            auto *notification_task =
-                mx::tasking::runtime::new_task<NotificationTask<typename notifier_type<T>::value>>(core_id, _listener);
-            notification_task->annotate(std::uint16_t(target_channel_id));
-            mx::tasking::runtime::spawn(*notification_task, channel_id);
+            mx::tasking::runtime::spawn_batch(*build_probe_tasks[target_channel_id], channel_id);
         }
 
-        return mx::tasking::TaskResult::make_remove();
+        // All build/probe tasks are registered at the join counter; the
+        // partition task is done and runs the next phase when it arrives last.
+        return mx::tasking::TaskResult::make_succeed_and_remove(this->join_counter().arrive());
     }
 
 private:
-    Listener<typename notifier_type<T>::value> &_listener;
+    typename joined_by_type<T>::value &_joined_by;
     const std::uint32_t _batch_size;
     const std::size_t _count;
     const mx::resource::ptr *_hash_tables;
 
+    /**
+     * Creates a new build/probe task for the given channel and registers it at the join counter.
+     *
+     * @param core_id Core to allocate the task on.
+     * @param target_channel_id Channel of the hash table the task works on.
+     * @return The new build/probe task.
+     */
+    T *new_build_probe_task(const std::uint16_t core_id, const std::uint16_t target_channel_id)
+    {
+        auto *task = mx::tasking::runtime::new_task<T>(core_id, _joined_by, _batch_size,
+                                                       mx::tasking::runtime::numa_node_id(target_channel_id));
+        task->annotate(_hash_tables[target_channel_id], 64U);
+        this->join_counter().add();
+        return task;
+    }
+
+    /**
+     * @return The join counter all build/probe tasks (and this task) arrive at.
+     */
+    mx::tasking::JoinCounter &join_counter() noexcept
+    {
+        if constexpr (std::is_same<T, BuildTask>::value)
+        {
+            return _joined_by;
+        }
+        else
+        {
+            return _joined_by.join_counter();
+        }
+    }
+
     static std::uint16_t hash(const std::uint32_t key) { return std::hash<std::uint32_t>()(key); }
 };
 } // namespace application::hash_join
\ No newline at end of file
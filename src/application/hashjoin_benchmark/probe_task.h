@@ -1,6 +1,7 @@
 #pragma once
 
 #include "inline_hashtable.h"
+#include "merge_task.h"
 #include <iostream>
 #include <mx/tasking/task.h>
 #include <mx/util/vector.h>
@@ -11,9 +12,8 @@ namespace application::hash_join {
 class ProbeTask final : public mx::tasking::TaskInterface
 {
 public:
-    ProbeTask(mx::util::vector<std::pair<std::size_t, std::size_t>> &result_set, const std::size_t size,
-              const std::uint8_t /*numa_node_id*/)
-        : _result_set(result_set)
+    ProbeTask(MergeTask &merge_task, const std::size_t size, const std::uint8_t /*numa_node_id*/)
+        : _merge_task(merge_task)
     {
         _keys.reserve(size);
     }
@@ -22,18 +22,22 @@ public:
 
     mx::tasking::TaskResult execute(const std::uint16_t /*core_id*/, const std::uint16_t /*channel_id*/) override
     {
-        auto *hashtable = this->annotated_resource().get<InlineHashtable<std::uint32_t, std::size_t>>();
+        // Every hash table (and its channel) owns a result set.
+        const auto hashtable_resource = this->annotated_resource();
+        auto &result_set = _merge_task.result_set(hashtable_resource.channel_id());
+        auto *hashtable = hashtable_resource.get<InlineHashtable<std::uint32_t, std::size_t>>();
 
         for (const auto &[row_id, key] : _keys)
         {
             const auto row = hashtable->get(key);
             if (row != std::numeric_limits<std::size_t>::max())
             {
-                _result_set.emplace_back(std::make_pair(row_id, row));
+                result_set.emplace_back(std::make_pair(row_id, row));
             }
         }
 
-        return mx::tasking::TaskResult::make_remove();
+        // Merge the results after the last task of the probe phase.
+        return mx::tasking::TaskResult::make_succeed_and_remove(_merge_task.join_counter().arrive());
     }
 
     void emplace_back(const std::size_t row_id, const std::uint32_t key) noexcept
@@ -46,6 +50,6 @@ public:
 
 private:
     std::vector<std::pair<std::size_t, std::uint32_t>> _keys;
-    mx::util::vector<std::pair<std::size_t, std::size_t>> &_result_set;
+    MergeTask &_merge_task;
 };
 } // namespace application::hash_join
\ No newline at end of file
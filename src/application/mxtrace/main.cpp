@@ -0,0 +1,244 @@
+#include <mx/tasking/profiling/trace_format.h>
+#include <utility>
+
+#include <algorithm>
+#include <argparse.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace trace = mx::tasking::profiling::trace;
+
+struct Task
+{
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint64_t name_id;
+    std::uint64_t type;
+};
+
+struct Core
+{
+    std::vector<std::uint64_t> enqueues;
+    std::vector<Task> tasks;
+};
+
+bool read_trace(const std::string &file_name, std::vector<std::string> &names, std::vector<Core> &cores);
+void write_chrome_trace(const std::vector<std::string> &names, const std::vector<Core> &cores, std::ostream &out);
+void print_us(std::ostream &out, std::uint64_t ns);
+
+int main(int count_arguments, char **arguments)
+{
+    argparse::ArgumentParser argument_parser("mxtrace");
+    argument_parser.add_argument("trace").help("Binary trace written by the TaskingProfiler.");
+    argument_parser.add_argument("-o", "--out")
+        .help("Name of the file, the Chrome/Perfetto trace (JSON) will be written to; stdout if empty.")
+        .default_value(std::string(""));
+
+    // Parse arguments.
+    try
+    {
+        argument_parser.parse_args(count_arguments, arguments);
+    }
+    catch (std::runtime_error &e)
+    {
+        std::cout << argument_parser << std::endl;
+        return 1;
+    }
+
+    auto names = std::vector<std::string>{};
+    auto cores = std::vector<Core>{};
+    if (read_trace(argument_parser.get<std::string>("trace"), names, cores) == false)
+    {
+        std::cerr << "Could not read trace " << argument_parser.get<std::string>("trace") << std::endl;
+        return 1;
+    }
+
+    const auto out_file_name = argument_parser.get<std::string>("-o");
+    if (out_file_name.empty())
+    {
+        write_chrome_trace(names, cores, std::cout);
+    }
+    else
+    {
+        auto out_file = std::ofstream{out_file_name};
+        write_chrome_trace(names, cores, out_file);
+    }
+
+    return 0;
+}
+
+bool read_trace(const std::string &file_name, std::vector<std::string> &names, std::vector<Core> &cores)
+{
+    auto reader = trace::Reader{};
+    if (reader.open(file_name) == false)
+    {
+        return false;
+    }
+
+    cores.resize(reader.count_cores());
+    auto last_timestamp = std::vector<std::uint64_t>(reader.count_cores(), 0U);
+
+    auto tag = trace::Tag{};
+    while (reader.read_tag(tag))
+    {
+        auto core = std::uint64_t{0U};
+        auto delta = std::uint64_t{0U};
+        if (tag == trace::Name)
+        {
+            auto id = std::uint64_t{0U};
+            auto length = std::uint64_t{0U};
+            if (reader.read_varint(id) == false || reader.read_varint(length) == false)
+            {
+                return false;
+            }
+            names.resize(std::max(names.size(), id + 1U));
+            if (reader.read(names[id], length) == false)
+            {
+                return false;
+            }
+        }
+        else if (tag == trace::Task)
+        {
+            auto task = Task{};
+            if (reader.read_varint(core) == false || core >= cores.size() || reader.read_varint(task.name_id) == false ||
+                reader.read_varint(task.type) == false || reader.read_varint(delta) == false ||
+                reader.read_varint(task.duration) == false)
+            {
+                return false;
+            }
+            task.start = last_timestamp[core] += std::uint64_t(trace::zigzag_decode(delta));
+            cores[core].tasks.emplace_back(task);
+        }
+        else if (tag == trace::Enqueue)
+        {
+            if (reader.read_varint(core) == false || core >= cores.size() || reader.read_varint(delta) == false)
+            {
+                return false;
+            }
+            cores[core].enqueues.emplace_back(last_timestamp[core] += std::uint64_t(trace::zigzag_decode(delta)));
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // Records of a core are written when they are complete (tasks) or by different threads (enqueues).
+    for (auto &core : cores)
+    {
+        std::sort(core.enqueues.begin(), core.enqueues.end());
+        std::sort(core.tasks.begin(), core.tasks.end(),
+                  [](const auto &left, const auto &right) { return left.start < right.start; });
+    }
+
+    return true;
+}
+
+void print_us(std::ostream &out, const std::uint64_t ns)
+{
+    const auto remainder = ns % 1000U;
+    out << ns / 1000U << '.' << char('0' + remainder / 100U) << char('0' + remainder / 10U % 10U)
+        << char('0' + remainder % 10U);
+}
+
+void write_chrome_trace(const std::vector<std::string> &names, const std::vector<Core> &cores, std::ostream &out)
+{
+    // Demangle every name once.
+    auto demangled_names = std::vector<std::string>{};
+    demangled_names.reserve(names.size());
+    for (const auto &name : names)
+    {
+        auto *demangled_name = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, nullptr);
+        demangled_names.emplace_back(demangled_name != nullptr ? demangled_name : name);
+        std::free(demangled_name);
+    }
+
+    auto first_time = std::numeric_limits<std::uint64_t>::max();
+    for (const auto &core : cores)
+    {
+        if (core.enqueues.empty() == false)
+        {
+            first_time = std::min(first_time, core.enqueues.front());
+        }
+        if (core.tasks.empty() == false)
+        {
+            first_time = std::min(first_time, core.tasks.front().start);
+        }
+    }
+
+    out << "{\"traceEvents\":[\n";
+    for (auto core_id = 0U; core_id < cores.size(); ++core_id)
+    {
+        const auto &core = cores[core_id];
+
+        // Metadata events for each core (CPU instead of process as name).
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << core_id << ",\"tid\":" << core_id
+            << ",\"args\":{\"name\":\"CPU\"}},\n";
+        out << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << core_id << ",\"tid\":" << core_id
+            << ",\"args\":{\"name\":" << core_id << "}},\n";
+
+        const auto counter = [&out, core_id](const std::uint64_t timestamp, const char *name,
+                                             const std::uint64_t value) {
+            out << "{\"pid\":" << core_id << ",\"name\":\"CPU" << core_id << "\",\"ph\":\"C\",\"ts\":";
+            print_us(out, timestamp);
+            out << ",\"args\":{\"" << name << "\":" << value << "}},\n";
+        };
+
+        // Task queue length: Enqueues increment, executed tasks decrement.
+        auto task_queue_length = std::uint64_t{0U};
+        if (core.enqueues.empty() == false)
+        {
+            counter(0U, "TaskQueueLength", task_queue_length);
+        }
+
+        auto enqueue = core.enqueues.begin();
+        auto last_end = std::uint64_t{0U};
+        for (const auto &task : core.tasks)
+        {
+            for (; enqueue != core.enqueues.end() && *enqueue < task.start; ++enqueue)
+            {
+                counter(*enqueue - first_time, "TaskQueueLength", ++task_queue_length);
+            }
+
+            const auto start = task.start - first_time;
+            if (core.enqueues.empty() == false)
+            {
+                task_queue_length -= task_queue_length > 0U;
+                counter(start, "TaskQueueLength", task_queue_length);
+            }
+
+            // Task itself.
+            out << "{\"pid\":" << core_id << ",\"tid\":" << core_id << ",\"ts\":";
+            print_us(out, start);
+            out << ",\"dur\":";
+            print_us(out, task.duration);
+            out << ",\"ph\":\"X\",\"name\":\""
+                << (task.name_id < demangled_names.size() ? demangled_names[task.name_id] : std::string{"unknown"})
+                << "\",\"args\":{\"type\":" << task.type << "}},\n";
+
+            // Reset throughput if there is a gap of more than 1us.
+            if (last_end != 0U && start > last_end + 1000U)
+            {
+                counter(last_end, "TaskThroughput", 0U);
+            }
+
+            // Tasks per microsecond.
+            counter(start, "TaskThroughput", 1000U / std::max(task.duration, std::uint64_t(1U)));
+            last_end = start + task.duration;
+        }
+
+        for (; enqueue != core.enqueues.end(); ++enqueue)
+        {
+            counter(*enqueue - first_time, "TaskQueueLength", ++task_queue_length);
+        }
+    }
+
+    // Sample event, so the last event needs no special handling of the comma.
+    out << "{\"name\":\"sample\",\"ph\":\"P\",\"ts\":0,\"pid\":0,\"tid\":0}]}" << std::endl;
+}
\ No newline at end of file
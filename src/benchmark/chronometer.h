@@ -2,14 +2,19 @@
 
 #include "perf.h"
 #include "phase.h"
+#include <algorithm>
 #include <chrono>
 #include <json.hpp>
+#include <mx/memory/config.h>
+#include <mx/memory/global_heap.h>
 #include <mx/tasking/config.h>
 #include <mx/tasking/profiling/statistic.h>
 #include <mx/tasking/runtime.h>
 #include <mx/util/core_set.h>
 #include <numeric>
 #include <ostream>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -33,13 +38,52 @@ template <typename P> class InterimResult
             stream << "\t" << value_per_operation << " " << name << "/op";
         }
 
-        if constexpr (mx::tasking::config::task_statistics())
+        // Memory backed by reserved and transparent huge pages in MiB.
+        if constexpr (mx::memory::config::huge_page_size() > 0U)
+        {
+            const auto &huge_page_memory = result.huge_page_memory();
+            stream << "\t" << (huge_page_memory.backed_explicit >> 20U) << "/"
+                   << (huge_page_memory.backed_transparent >> 20U) << " MiB huge pages";
+        }
+
+        if (mx::tasking::diagnostics::is_statistics_enabled())
         {
             stream << "\t" << result.executed_writer_tasks() / double(result.operation_count()) << " writer/op";
             stream << "\t" << result.executed_reader_tasks() / double(result.operation_count()) << " reader/op";
             stream << "\t" << result.scheduled_tasks_on_core() / double(result.operation_count()) << " on-channel/op";
             stream << "\t" << result.scheduled_tasks_off_core() / double(result.operation_count()) << " off-channel/op";
             stream << "\t" << result.worker_fills() / double(result.operation_count()) << " fills/op";
+
+            // Memory taken from the OS per NUMA node in MiB.
+            for (const auto &numa_memory_usage : result.memory_usage())
+            {
+                stream << "\t" << (numa_memory_usage.global_heap >> 20U) << " MiB@node"
+                       << std::uint32_t(numa_memory_usage.numa_node_id);
+            }
+            for (const auto &[name, value] : result.counters())
+            {
+                stream << "\t" << value / double(result.operation_count()) << " " << name << "/op";
+            }
+
+            // One line per task type: Percentiles of queueing and execution time.
+            for (const auto &latency : result.task_latencies())
+            {
+                stream << "\n\t" << latency.name << "\t" << latency.count << " tasks"
+                       << "\tqueueing p50/p99 " << latency.queueing[0U] << "/" << latency.queueing[2U] << " ns"
+                       << "\texecution p50/p99 " << latency.execution[0U] << "/" << latency.execution[2U] << " ns"
+                       << "\t" << latency.failed_validations << " failed validations";
+
+                // Hardware performance counters per task of the type.
+                if constexpr (mx::tasking::config::task_perf_counters())
+                {
+                    const auto names = mx::tasking::profiling::PerfCounters::names();
+                    for (auto event = 0U; event < names.size(); ++event)
+                    {
+                        const auto count = double(std::max(latency.count, std::uint64_t(1U)));
+                        stream << "\t" << latency.perf_counters[event] / count << " " << names[event] << "/task";
+                    }
+                }
+            }
         }
 
         return stream << std::flush;
@@ -54,12 +98,17 @@ public:
                   std::unordered_map<std::uint16_t, std::uint64_t> scheduled_tasks,
                   std::unordered_map<std::uint16_t, std::uint64_t> scheduled_tasks_on_core,
                   std::unordered_map<std::uint16_t, std::uint64_t> scheduled_tasks_off_core,
-                  std::unordered_map<std::uint16_t, std::uint64_t> worker_fills)
+                  std::unordered_map<std::uint16_t, std::uint64_t> worker_fills,
+                  std::vector<std::pair<std::string, std::uint64_t>> counters,
+                  std::vector<mx::tasking::profiling::TaskLatency> task_latencies)
         : _operation_count(operation_count), _phase(phase), _iteration(iteration), _core_count(core_count), _time(time),
           _executed_tasks(std::move(executed_tasks)), _executed_reader_tasks(std::move(executed_reader_tasks)),
           _executed_writer_tasks(std::move(executed_writer_tasks)), _scheduled_tasks(std::move(scheduled_tasks)),
           _scheduled_tasks_on_core(std::move(scheduled_tasks_on_core)),
-          _scheduled_tasks_off_core(std::move(scheduled_tasks_off_core)), _worker_fills(std::move(worker_fills))
+          _scheduled_tasks_off_core(std::move(scheduled_tasks_off_core)), _worker_fills(std::move(worker_fills)),
+          _counters(std::move(counters)), _task_latencies(std::move(task_latencies)),
+          _huge_page_memory(mx::memory::GlobalHeap::huge_page_memory()),
+          _memory_usage(mx::tasking::runtime::memory_usage())
     {
         for (auto &c : counter)
         {
@@ -113,6 +162,14 @@ public:
         return _scheduled_tasks_off_core.at(channel_id);
     }
     std::uint64_t worker_fills(const std::uint16_t channel_id) const noexcept { return _worker_fills.at(channel_id); }
+    const std::vector<std::pair<std::string, std::uint64_t>> &counters() const noexcept { return _counters; }
+    const std::vector<mx::tasking::profiling::TaskLatency> &task_latencies() const noexcept
+    {
+        return _task_latencies;
+    }
+
+    const mx::memory::HugePageMemory &huge_page_memory() const noexcept { return _huge_page_memory; }
+    const std::vector<mx::memory::NumaMemoryUsage> &memory_usage() const noexcept { return _memory_usage; }
 
     [[nodiscard]] nlohmann::json to_json() const noexcept
     {
@@ -126,13 +183,74 @@ public:
             json[name] = value / double(operation_count());
         }
 
-        if constexpr (mx::tasking::config::task_statistics())
+        if constexpr (mx::memory::config::huge_page_size() > 0U)
+        {
+            json["huge-pages"]["allocated-explicit"] = huge_page_memory().allocated_explicit;
+            json["huge-pages"]["allocated-transparent"] = huge_page_memory().allocated_transparent;
+            json["huge-pages"]["backed-explicit"] = huge_page_memory().backed_explicit;
+            json["huge-pages"]["backed-transparent"] = huge_page_memory().backed_transparent;
+        }
+
+        if (mx::tasking::diagnostics::is_statistics_enabled())
         {
             json["executed-writer-tasks"] = executed_writer_tasks() / double(operation_count());
             json["executed-reader-tasks"] = executed_reader_tasks() / double(operation_count());
             json["scheduled-tasks-on-channel"] = scheduled_tasks_on_core() / double(operation_count());
             json["scheduled-tasks-off-channel"] = scheduled_tasks_off_core() / double(operation_count());
             json["buffer-fills"] = worker_fills() / double(operation_count());
+
+            auto memory_usage_json = nlohmann::json::array();
+            for (const auto &numa_memory_usage : memory_usage())
+            {
+                const auto to_json = [](const mx::memory::MemoryUsage &usage) {
+                    return nlohmann::json{
+                        {"reserved", usage.reserved}, {"in-use", usage.in_use}, {"fragmented", usage.fragmented}};
+                };
+
+                auto numa_memory_usage_json = nlohmann::json{};
+                numa_memory_usage_json["numa-node"] = numa_memory_usage.numa_node_id;
+                numa_memory_usage_json["global-heap"] = numa_memory_usage.global_heap;
+                numa_memory_usage_json["refused-allocations"] = numa_memory_usage.refused_allocations;
+                numa_memory_usage_json["tasks"] = to_json(numa_memory_usage.tasks);
+                numa_memory_usage_json["cross-node-task-frees"] = numa_memory_usage.cross_node_task_frees;
+                numa_memory_usage_json["allocation-blocks"] = to_json(numa_memory_usage.allocation_blocks);
+                for (const auto &size_class_usage : numa_memory_usage.size_classes)
+                {
+                    numa_memory_usage_json["size-classes"].emplace_back(to_json(size_class_usage));
+                }
+                memory_usage_json.emplace_back(std::move(numa_memory_usage_json));
+            }
+            json["memory"] = std::move(memory_usage_json);
+            for (const auto &[name, value] : counters())
+            {
+                json[name] = value / double(operation_count());
+            }
+
+            auto task_latencies_json = nlohmann::json::array();
+            for (const auto &latency : task_latencies())
+            {
+                auto latency_json = nlohmann::json{};
+                latency_json["name"] = latency.name;
+                latency_json["count"] = latency.count;
+                latency_json["failed-validations"] = latency.failed_validations;
+                for (auto i = 0U; i < mx::tasking::profiling::TaskLatency::percentiles.size(); ++i)
+                {
+                    auto percentile = std::ostringstream{};
+                    percentile << "p" << mx::tasking::profiling::TaskLatency::percentiles[i] * 100.0;
+                    latency_json["queueing-ns"][percentile.str()] = latency.queueing[i];
+                    latency_json["execution-ns"][percentile.str()] = latency.execution[i];
+                }
+                if constexpr (mx::tasking::config::task_perf_counters())
+                {
+                    const auto names = mx::tasking::profiling::PerfCounters::names();
+                    for (auto event = 0U; event < names.size(); ++event)
+                    {
+                        latency_json["perf-counters"][names[event]] = latency.perf_counters[event];
+                    }
+                }
+                task_latencies_json.emplace_back(std::move(latency_json));
+            }
+            json["task-latencies"] = std::move(task_latencies_json);
         }
 
         return json;
@@ -152,6 +270,10 @@ private:
     const std::unordered_map<std::uint16_t, std::uint64_t> _scheduled_tasks_on_core;
     const std::unordered_map<std::uint16_t, std::uint64_t> _scheduled_tasks_off_core;
     const std::unordered_map<std::uint16_t, std::uint64_t> _worker_fills;
+    const std::vector<std::pair<std::string, std::uint64_t>> _counters;
+    const std::vector<mx::tasking::profiling::TaskLatency> _task_latencies;
+    const mx::memory::HugePageMemory _huge_page_memory;
+    const std::vector<mx::memory::NumaMemoryUsage> _memory_usage;
 
     std::uint64_t sum(const std::unordered_map<std::uint16_t, std::uint64_t> &map) const noexcept
     {
@@ -199,7 +321,9 @@ public:
                 statistic_map(mx::tasking::profiling::Statistic::Scheduled),
                 statistic_map(mx::tasking::profiling::Statistic::ScheduledOnChannel),
                 statistic_map(mx::tasking::profiling::Statistic::ScheduledOffChannel),
-                statistic_map(mx::tasking::profiling::Statistic::Fill)};
+                statistic_map(mx::tasking::profiling::Statistic::Fill),
+                other_counters(),
+                mx::tasking::runtime::statistic()};
     }
 
     void add(PerfCounter &performance_counter) { _perf.add(performance_counter); }
@@ -221,5 +345,18 @@ private:
         }
         return statistics;
     }
+
+    std::vector<std::pair<std::string, std::uint64_t>> other_counters()
+    {
+        const auto &counters = mx::tasking::runtime::counters();
+
+        std::vector<std::pair<std::string, std::uint64_t>> other_counters;
+        // Counters without a dedicated field (e.g., stolen tasks or counters registered by applications).
+        for (auto id = std::uint16_t(mx::tasking::profiling::Statistic::Stolen); id < counters.count_counters(); ++id)
+        {
+            other_counters.emplace_back(counters.name(id), counters.get(id));
+        }
+        return other_counters;
+    }
 };
 } // namespace benchmark
\ No newline at end of file
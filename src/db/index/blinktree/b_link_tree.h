@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.h"
+#include "counters.h"
 #include "node.h"
 #include "node_consistency_checker.h"
 #include "node_iterator.h"
@@ -26,6 +27,7 @@ public:
         : _isolation_level(isolation_level), _preferred_synchronization_protocol(preferred_synchronization_protocol),
           _root(create_node(NodeType::Leaf, mx::resource::ptr{}, true))
     {
+        Counters::register_counters();
     }
 
     ~BLinkTree() { mx::tasking::runtime::delete_resource<Node<K, V>>(_root); }
@@ -151,6 +153,9 @@ protected:
      *
      * @param node_type Type of the node.
      * @param parent Parent of the node.
+     * Nodes are created while splitting, which can not be rolled back; the
+     * tree aborts when the memory limit refuses a new node.
+     *
      * @param is_root True, if the new node will be the root.
      * @return Pointer to the new node.
      */
@@ -158,11 +163,18 @@ protected:
                                                 const bool is_root) const
     {
         const auto is_inner = static_cast<bool>(node_type & NodeType::Inner);
-        return mx::tasking::runtime::new_resource<Node<K, V>>(
+        auto node = mx::tasking::runtime::new_resource<Node<K, V>>(
             config::node_size(),
             mx::resource::hint{_isolation_level, _preferred_synchronization_protocol,
                                predict_access_frequency(is_inner, is_root), predict_read_write_ratio(is_inner)},
             node_type, parent);
+        if (node == nullptr)
+        {
+            std::cerr << "Could not allocate a node: memory limit reached." << std::endl;
+            std::abort();
+        }
+
+        return node;
     }
 
     /**
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <mx/tasking/runtime.h>
+
+namespace db::index::blinktree {
+/**
+ * Counters of the B-link tree (splits and hops to the right sibling),
+ * recorded per channel together with the task statistics.
+ */
+class Counters
+{
+public:
+    /**
+     * Registers the counters at the runtime; called by every created tree.
+     */
+    static void register_counters()
+    {
+        _split = mx::tasking::runtime::register_counter("blinktree-splits");
+        _right_sibling_hop = mx::tasking::runtime::register_counter("blinktree-right-sibling-hops");
+    }
+
+    /**
+     * Counts a split of a node.
+     * @param channel_id Channel executing the splitting task.
+     */
+    static void split(const std::uint16_t channel_id) noexcept { mx::tasking::runtime::count(channel_id, _split); }
+
+    /**
+     * Counts a task following the right sibling, because the node was split concurrently.
+     * @param channel_id Channel executing the task.
+     */
+    static void right_sibling_hop(const std::uint16_t channel_id) noexcept
+    {
+        mx::tasking::runtime::count(channel_id, _right_sibling_hop);
+    }
+
+private:
+    inline static mx::tasking::profiling::CounterRegistry::counter_id_t _split{0U};
+    inline static mx::tasking::profiling::CounterRegistry::counter_id_t _right_sibling_hop{0U};
+};
+} // namespace db::index::blinktree
\ No newline at end of file
@@ -26,13 +26,14 @@ private:
 
 template <typename K, typename V, class L>
 mx::tasking::TaskResult InsertSeparatorTask<K, V, L>::execute(const std::uint16_t core_id,
-                                                              const std::uint16_t /*channel_id*/)
+                                                              const std::uint16_t channel_id)
 {
     auto *annotated_node = this->annotated_resource().template get<Node<K, V>>();
 
     // Is the node related to the key?
     if (annotated_node->high_key() <= this->_key)
     {
+        Counters::right_sibling_hop(channel_id);
         this->annotate(annotated_node->right_sibling(), config::node_size() / 4U);
         return mx::tasking::TaskResult::make_succeed(this);
     }
@@ -47,6 +48,7 @@ mx::tasking::TaskResult InsertSeparatorTask<K, V, L>::execute(const std::uint16_
         return mx::tasking::TaskResult::make_remove();
     }
 
+    Counters::split(channel_id);
     auto [right, key] = this->_tree->split(this->annotated_resource(), this->_key, this->_separator);
     if (annotated_node->parent() != nullptr)
     {
@@ -26,14 +26,14 @@ private:
 };
 
 template <typename K, typename V, class L>
-mx::tasking::TaskResult InsertValueTask<K, V, L>::execute(const std::uint16_t core_id,
-                                                          const std::uint16_t /*channel_id*/)
+mx::tasking::TaskResult InsertValueTask<K, V, L>::execute(const std::uint16_t core_id, const std::uint16_t channel_id)
 {
     auto *annotated_node = this->annotated_resource().template get<Node<K, V>>();
 
     // Is the node related to the key?
     if (annotated_node->high_key() <= this->_key)
     {
+        Counters::right_sibling_hop(channel_id);
         this->annotate(annotated_node->right_sibling(), config::node_size() / 4U);
         return mx::tasking::TaskResult::make_succeed(this);
     }
@@ -69,6 +69,7 @@ mx::tasking::TaskResult InsertValueTask<K, V, L>::execute(const std::uint16_t co
         return mx::tasking::TaskResult::make_remove();
     }
 
+    Counters::split(channel_id);
     auto [right, key] = this->_tree->split(this->annotated_resource(), this->_key, this->_value);
     if (annotated_node->parent() != nullptr)
     {
@@ -23,13 +23,14 @@ private:
 };
 
 template <typename K, typename V, typename L>
-mx::tasking::TaskResult UpdateTask<K, V, L>::execute(const std::uint16_t core_id, const std::uint16_t /*channel_id*/)
+mx::tasking::TaskResult UpdateTask<K, V, L>::execute(const std::uint16_t core_id, const std::uint16_t channel_id)
 {
     auto *node = this->annotated_resource().template get<Node<K, V>>();
 
     // Is the node related to the key?
     if (node->high_key() <= this->_key)
     {
+        Counters::right_sibling_hop(channel_id);
         this->annotate(node->right_sibling(), config::node_size() / 4U);
         return mx::tasking::TaskResult::make_succeed(this);
     }
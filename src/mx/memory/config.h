@@ -15,9 +15,57 @@ public:
      */
     static constexpr auto epoch_interval() { return std::chrono::milliseconds(50U); }
 
+    /**
+     * @return Maximal number of allocation blocks per NUMA region (at least 256 MiB each).
+     */
+    static constexpr auto max_allocation_blocks() { return 1024U; }
+
+    /**
+     * @return Time an allocation block has to stay free before its memory is returned
+     *         to the OS by the epoch manager; zero disables returning memory.
+     */
+    static constexpr auto trim_unused_memory_after() { return std::chrono::milliseconds(1000U); }
+
     /**
      * @return True, if garbage is removed local.
      */
     static constexpr auto local_garbage_collection() { return false; }
+
+    /**
+     * @return Size of huge pages (2 MiB or 1 GiB) backing memory allocated from the
+     *         global heap, e.g., chunks and allocation blocks; zero uses regular pages.
+     *         Without reserved huge pages, transparent huge pages are requested.
+     */
+    static constexpr auto huge_page_size() { return 0UL; }
+
+    /**
+     * @return Number of tasks of another NUMA node, collected by a core before handing them back to their node.
+     */
+    static constexpr auto cross_node_free_batch_size() { return 64U; }
+
+    /**
+     * @return True, if small objects are allocated from per-core size classes.
+     */
+    static constexpr auto size_class_allocator() { return true; }
+
+    /**
+     * @return Size of the smallest size class; size classes are powers of two.
+     */
+    static constexpr auto min_size_class() { return 64UL; }
+
+    /**
+     * @return Number of size classes (64 byte up to 4 kB); larger objects use allocation blocks.
+     */
+    static constexpr auto count_size_classes() { return 7U; }
+
+    /**
+     * @return Size of a span, holding objects of a single size class for a single core.
+     */
+    static constexpr auto size_class_span_size() { return 256UL * 1024UL; }
+
+    /**
+     * @return Virtual memory reserved for size classes per NUMA region.
+     */
+    static constexpr auto size_class_region_size() { return 64UL * 1024UL * 1024UL * 1024UL; }
 };
 } // namespace mx::memory
\ No newline at end of file
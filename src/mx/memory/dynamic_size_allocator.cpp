@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <mx/system/topology.h>
+#include <sys/mman.h>
 
 using namespace mx::memory::dynamic;
 
@@ -10,32 +11,58 @@ AllocationBlock::AllocationBlock(const std::uint32_t id, const std::uint8_t numa
     : _id(id), _numa_node_id(numa_node_id), _size(size), _available_size(size)
 {
     this->_allocated_block = GlobalHeap::allocate(numa_node_id, size);
-    this->_free_elements.emplace_back(FreeHeader{reinterpret_cast<std::uintptr_t>(this->_allocated_block), size});
+    if (this->_allocated_block != nullptr)
+    {
+        this->_free_elements.emplace_back(FreeHeader{reinterpret_cast<std::uintptr_t>(this->_allocated_block), size});
+    }
+    else
+    {
+        this->available_size(0U);
+    }
 }
 
 AllocationBlock::AllocationBlock(AllocationBlock &&other) noexcept
     : _id(other._id), _numa_node_id(other._numa_node_id), _size(other._size),
       _allocated_block(std::exchange(other._allocated_block, nullptr)), _free_elements(std::move(other._free_elements)),
-      _available_size(other._available_size)
+      _available_size(other.available_size()), _unused_since(other._unused_since), _is_trimmed(other._is_trimmed)
 {
 }
 
 AllocationBlock &AllocationBlock::operator=(AllocationBlock &&other) noexcept
 {
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    this->release();
+
     this->_id = other._id;
     this->_numa_node_id = other._numa_node_id;
     this->_size = other._size;
     this->_allocated_block = std::exchange(other._allocated_block, nullptr);
     this->_free_elements = std::move(other._free_elements);
-    this->_available_size = other._available_size;
+    this->available_size(other.available_size());
+    this->_unused_since = other._unused_since;
+    this->_is_trimmed = other._is_trimmed;
     return *this;
 }
 
 AllocationBlock::~AllocationBlock()
+{
+    this->release();
+}
+
+void AllocationBlock::release() noexcept
 {
     if (this->_allocated_block != nullptr)
     {
-        GlobalHeap::free(this->_allocated_block, this->_size);
+        // Trimmed memory was already accounted as released.
+        if (this->_is_trimmed)
+        {
+            GlobalHeap::count_reserved(this->_numa_node_id, this->_size);
+        }
+        GlobalHeap::free(std::exchange(this->_allocated_block, nullptr), this->_size, this->_numa_node_id);
     }
 }
 
@@ -44,7 +71,7 @@ void *AllocationBlock::allocate(const std::size_t alignment, const std::size_t s
     assert(alignment && (!(alignment & (alignment - 1))) && "Alignment must be > 0 and power of 2");
     this->_lock.lock();
 
-    if (this->_available_size < size)
+    if (this->available_size() < size)
     {
         this->_lock.unlock();
         return nullptr;
@@ -66,13 +93,20 @@ void *AllocationBlock::allocate(const std::size_t alignment, const std::size_t s
     {
         const auto index = std::distance(this->_free_elements.begin(), free_element_iterator);
         this->_free_elements[index].contract(aligned_size_including_header);
-        this->_available_size -= aligned_size_including_header;
+        this->available_size(this->available_size() - aligned_size_including_header);
     }
     else
     {
         size_before_header = remaining_size;
+        this->available_size(this->available_size() - free_element_iterator->size());
         this->_free_elements.erase(free_element_iterator);
-        this->_available_size -= free_element_iterator->size();
+    }
+    this->_unused_since = std::chrono::steady_clock::time_point::min();
+    if (this->_is_trimmed)
+    {
+        // The OS hands out the trimmed memory again on first touch.
+        GlobalHeap::count_reserved(this->_numa_node_id, this->_size);
+        this->_is_trimmed = false;
     }
     this->_lock.unlock();
 
@@ -132,11 +166,58 @@ void AllocationBlock::free(AllocatedHeader *allocation_header) noexcept
             this->_free_elements.insert(this->_free_elements.begin() + real_index, free_element);
         }
     }
-    this->_available_size += free_element.size();
+    this->available_size(this->available_size() + free_element.size());
 
     this->_lock.unlock();
 }
 
+std::size_t AllocationBlock::trim(const std::chrono::steady_clock::time_point now,
+                                  const std::chrono::milliseconds unused_time) noexcept
+{
+    auto trimmed_size = std::size_t{0U};
+
+    // Allocations carve from the block while locked; a free block can not be in use while locked.
+    this->_lock.lock();
+    if (this->_is_trimmed == false && this->is_free())
+    {
+        if (this->_unused_since == std::chrono::steady_clock::time_point::min())
+        {
+            this->_unused_since = now;
+        }
+        else if (now - this->_unused_since >= unused_time)
+        {
+            ::madvise(this->_allocated_block, this->_size, MADV_DONTNEED);
+            GlobalHeap::count_released(this->_numa_node_id, this->_size);
+            this->_is_trimmed = true;
+            trimmed_size = this->_size;
+        }
+    }
+    this->_lock.unlock();
+
+    return trimmed_size;
+}
+
+mx::memory::MemoryUsage AllocationBlock::usage() noexcept
+{
+    // Do not delay allocations: The free list is only read when the block is not in use.
+    if (this->_lock.try_lock() == false)
+    {
+        const auto available_size = this->available_size();
+        return MemoryUsage{this->_size, this->_size - available_size, 0U};
+    }
+
+    auto largest_free_size = std::size_t{0U};
+    for (const auto &free_element : this->_free_elements)
+    {
+        largest_free_size = std::max(largest_free_size, std::size_t(free_element.size()));
+    }
+    const auto available_size = this->available_size();
+    const auto reserved_size = this->_is_trimmed ? 0U : this->_size;
+    this->_lock.unlock();
+
+    return MemoryUsage{reserved_size, this->_size - available_size, available_size - largest_free_size};
+}
+
 std::pair<std::vector<FreeHeader>::iterator, std::size_t> AllocationBlock::find_block(const std::size_t alignment,
                                                                                       const std::size_t size) noexcept
 {
@@ -188,6 +269,38 @@ std::pair<std::vector<FreeHeader>::iterator, std::size_t> AllocationBlock::find_
     return std::make_pair(this->_free_elements.end(), 0U);
 }
 
+void AllocationBlockList::remove_free() noexcept
+{
+    auto count_blocks = std::uint32_t{0U};
+    for (auto &block : *this)
+    {
+        if (block.is_free() == false)
+        {
+            if (&block != &this->_blocks[count_blocks])
+            {
+                this->_blocks[count_blocks] = std::move(block);
+            }
+            ++count_blocks;
+        }
+    }
+
+    // Free the blocks behind the remaining ones.
+    for (auto i = count_blocks; i < this->size(); ++i)
+    {
+        this->_blocks[i] = AllocationBlock{};
+    }
+    this->_size.store(count_blocks, std::memory_order_release);
+}
+
+void AllocationBlockList::clear() noexcept
+{
+    for (auto &block : *this)
+    {
+        block = AllocationBlock{};
+    }
+    this->_size.store(0U, std::memory_order_release);
+}
+
 Allocator::Allocator()
 {
     this->initialize_empty();
@@ -195,6 +308,20 @@ Allocator::Allocator()
 
 void *Allocator::allocate(const std::uint8_t numa_node_id, const std::size_t alignment, const std::size_t size) noexcept
 {
+    // Small objects are allocated latch-free from the size classes of the calling core.
+    if constexpr (config::size_class_allocator())
+    {
+        const auto size_class = SizeClassAllocator::size_class(alignment, size);
+        if (size_class < config::count_size_classes())
+        {
+            auto *memory = this->_size_class_allocator.allocate(numa_node_id, size_class);
+            if (memory != nullptr)
+            {
+                return memory;
+            }
+        }
+    }
+
     auto &allocation_blocks = this->_numa_allocation_blocks[numa_node_id];
 
     auto *memory = allocation_blocks.back().allocate(alignment, size);
@@ -206,13 +333,25 @@ void *Allocator::allocate(const std::uint8_t numa_node_id, const std::size_t ali
         // ... but if the requested size is higher, allocate more.
         const auto size_to_alloc = std::max(default_alloc_size, alignment_helper::next_multiple(size, 64UL));
 
+        // Beyond the soft limit, free space of older blocks is reused before taking new memory.
+        if (GlobalHeap::exceeds_soft_limit(numa_node_id, size_to_alloc))
+        {
+            memory = Allocator::allocate_from_any_block(allocation_blocks, alignment, size);
+        }
+
         // Try to allocate until allocation was successful.
         // It is possible, that another core tries to allocate at the
         // same time, therefore we capture the allocation flag (one per region)
         auto &flag = this->_numa_allocation_flags[numa_node_id].value();
         while (memory == nullptr)
         {
-            allocate_new_block(numa_node_id, size_to_alloc, allocation_blocks, flag);
+            // Beyond the hard limit, the allocation fails instead of taking new memory.
+            if (GlobalHeap::exceeds_hard_limit(numa_node_id, size_to_alloc) ||
+                allocate_new_block(numa_node_id, size_to_alloc, allocation_blocks, flag) == false)
+            {
+                this->_count_refused_allocations[numa_node_id].value().fetch_add(1U, std::memory_order_relaxed);
+                return nullptr;
+            }
             memory = allocation_blocks.back().allocate(alignment, size);
         }
     }
@@ -220,8 +359,23 @@ void *Allocator::allocate(const std::uint8_t numa_node_id, const std::size_t ali
     return memory;
 }
 
-void Allocator::allocate_new_block(const std::uint8_t numa_node_id, const std::size_t size,
-                                   std::vector<AllocationBlock> &blocks, std::atomic<bool> &flag)
+void *Allocator::allocate_from_any_block(AllocationBlockList &blocks, const std::size_t alignment,
+                                         const std::size_t size) noexcept
+{
+    for (auto *block = blocks.end(); block != blocks.begin(); --block)
+    {
+        auto *memory = std::prev(block)->allocate(alignment, size);
+        if (memory != nullptr)
+        {
+            return memory;
+        }
+    }
+
+    return nullptr;
+}
+
+bool Allocator::allocate_new_block(const std::uint8_t numa_node_id, const std::size_t size,
+                                   AllocationBlockList &blocks, std::atomic<bool> &flag)
 {
     // Acquire the allocation flag to ensure only one thread to allocate.
     auto expected = false;
@@ -231,19 +385,23 @@ void Allocator::allocate_new_block(const std::uint8_t numa_node_id, const std::s
     {
         // If that was this thread go for it...
         const auto next_id = this->_next_allocation_id[numa_node_id].value().fetch_add(1U, std::memory_order_acq_rel);
-        blocks.emplace_back(AllocationBlock{next_id, numa_node_id, size});
+        auto block = AllocationBlock{next_id, numa_node_id, size};
+
+        // The block is freed when the list is exhausted.
+        const auto is_allocated = block.is_allocated() && blocks.push_back(std::move(block));
 
         // .. but release the allocation flag afterward.
         flag.store(false);
+        return is_allocated;
     }
-    else
+
+    // If that was another thread, wait until he finished.
+    while (flag.load())
     {
-        // If that was another thread, wait until he finished.
-        while (flag.load())
-        {
-            system::builtin::pause();
-        }
+        system::builtin::pause();
     }
+
+    return true;
 }
 
 void Allocator::free(void *pointer) noexcept
@@ -253,6 +411,15 @@ void Allocator::free(void *pointer) noexcept
     // the global heap that is managed by the operating system.
     const auto address = reinterpret_cast<std::uintptr_t>(pointer);
 
+    // Objects of size classes have no header, they are identified by their address.
+    if constexpr (config::size_class_allocator())
+    {
+        if (this->_size_class_allocator.free(pointer))
+        {
+            return;
+        }
+    }
+
     // Access the header to identify the allocation block.
     const auto header_address = address - sizeof(AllocatedHeader);
     auto *allocation_header = reinterpret_cast<AllocatedHeader *>(header_address);
@@ -273,16 +440,28 @@ void Allocator::defragment() noexcept
     // Remove all blocks that are unused to free as much memory as possible.
     for (auto i = 0U; i <= system::topology::max_node_id(); ++i)
     {
-        auto &numa_blocks = this->_numa_allocation_blocks[i];
-        numa_blocks.erase(
-            std::remove_if(numa_blocks.begin(), numa_blocks.end(), [](const auto &block) { return block.is_free(); }),
-            numa_blocks.end());
+        this->_numa_allocation_blocks[i].remove_free();
     }
 
     // If all memory was released, acquire new.
     this->initialize_empty();
 }
 
+std::size_t Allocator::trim(const std::chrono::steady_clock::time_point now,
+                            const std::chrono::milliseconds unused_time) noexcept
+{
+    auto trimmed_size = this->_size_class_allocator.trim(now, unused_time);
+    for (auto i = 0U; i <= system::topology::max_node_id(); ++i)
+    {
+        for (auto &block : this->_numa_allocation_blocks[i])
+        {
+            trimmed_size += block.trim(now, unused_time);
+        }
+    }
+
+    return trimmed_size;
+}
+
 void Allocator::initialize_empty()
 {
     // For performance reasons: Each list must contain at least
@@ -293,21 +472,26 @@ void Allocator::initialize_empty()
         if (blocks.empty())
         {
             const auto next_id = this->_next_allocation_id[i].value().fetch_add(1U, std::memory_order_relaxed);
-            blocks.emplace_back(AllocationBlock{next_id, std::uint8_t(i), 4096U * 4096U});
+            blocks.push_back(AllocationBlock{next_id, std::uint8_t(i), 4096U * 4096U});
         }
     }
 }
 
 bool Allocator::is_free() const noexcept
 {
+    if (this->_size_class_allocator.is_free() == false)
+    {
+        return false;
+    }
+
     for (auto i = 0U; i <= system::topology::max_node_id(); ++i)
     {
         const auto &numa_blocks = this->_numa_allocation_blocks[i];
-        const auto iterator = std::find_if(numa_blocks.cbegin(), numa_blocks.cend(), [](const auto &allocation_block) {
+        const auto iterator = std::find_if(numa_blocks.begin(), numa_blocks.end(), [](const auto &allocation_block) {
             return allocation_block.is_free() == false;
         });
 
-        if (iterator != numa_blocks.cend())
+        if (iterator != numa_blocks.end())
         {
             return false;
         }
@@ -316,8 +500,21 @@ bool Allocator::is_free() const noexcept
     return true;
 }
 
+mx::memory::MemoryUsage Allocator::usage(const std::uint8_t numa_node_id) noexcept
+{
+    auto usage = MemoryUsage{};
+    for (auto &block : this->_numa_allocation_blocks[numa_node_id])
+    {
+        usage += block.usage();
+    }
+
+    return usage;
+}
+
 void Allocator::release_allocated_memory() noexcept
 {
+    this->_size_class_allocator.release();
+
     for (auto i = 0U; i <= system::topology::max_node_id(); ++i)
     {
         this->_numa_allocation_blocks[i].clear();
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "config.h"
+#include "memory_usage.h"
+#include "size_class_allocator.h"
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mx/synchronization/spinlock.h>
 #include <mx/util/aligned_t.h>
 #include <utility>
@@ -78,6 +83,7 @@ struct AllocatedHeader
 class AllocationBlock
 {
 public:
+    AllocationBlock() noexcept = default;
     AllocationBlock(std::uint32_t id, std::uint8_t numa_node_id, std::size_t size);
     AllocationBlock(const AllocationBlock &other) = delete;
     AllocationBlock(AllocationBlock &&other) noexcept;
@@ -105,32 +111,134 @@ public:
      */
     [[nodiscard]] std::uint32_t id() const noexcept { return _id; }
 
+    /**
+     * @return True, if the memory of the block could be allocated from the global heap.
+     */
+    [[nodiscard]] bool is_allocated() const noexcept { return _allocated_block != nullptr; }
+
+    /**
+     * Reads the memory held by the block without waiting for allocations: While the
+     * block is locked, its fragmentation is not read and reported as zero.
+     *
+     * @return Memory held by the block.
+     */
+    [[nodiscard]] MemoryUsage usage() noexcept;
+
     /**
      * @return True, if the full block is free.
      */
     [[nodiscard]] bool is_free() const noexcept
     {
-        return _free_elements.empty() || (_free_elements.size() == 1 && _free_elements[0].size() == _size);
+        // Without free elements, the block is fully allocated.
+        return _free_elements.size() == 1 && _free_elements[0].size() == _size;
     }
 
+    /**
+     * Returns the memory of the block to the OS, when the block stayed free for the given time.
+     * The block keeps its address range; pages are backed again when allocated.
+     *
+     * @param now Current time.
+     * @param unused_time Time the block has to stay free.
+     * @return Number of bytes returned to the OS.
+     */
+    std::size_t trim(std::chrono::steady_clock::time_point now, std::chrono::milliseconds unused_time) noexcept;
+
 private:
-    alignas(64) std::uint32_t _id;
-    std::uint8_t _numa_node_id;
-    std::size_t _size;
+    alignas(64) std::uint32_t _id{0U};
+    std::uint8_t _numa_node_id{0U};
+    std::size_t _size{0U};
 
-    void *_allocated_block;
+    void *_allocated_block{nullptr};
     std::vector<FreeHeader> _free_elements;
 
-    alignas(64) std::size_t _available_size;
+    // Written while locked, read without lock by usage().
+    alignas(64) std::atomic_size_t _available_size{0U};
     synchronization::Spinlock _lock;
 
+    // Time the block was seen fully free first, reset by allocations.
+    std::chrono::steady_clock::time_point _unused_since{std::chrono::steady_clock::time_point::min()};
+
+    // True, if the memory was returned to the OS and not allocated since.
+    bool _is_trimmed{false};
+
+    [[nodiscard]] std::size_t available_size() const noexcept
+    {
+        return _available_size.load(std::memory_order_relaxed);
+    }
+    void available_size(const std::size_t size) noexcept { _available_size.store(size, std::memory_order_relaxed); }
+
+    /**
+     * Returns the memory of the block to the global heap.
+     */
+    void release() noexcept;
+
     std::pair<std::vector<FreeHeader>::iterator, std::size_t> find_block(std::size_t alignment,
                                                                          std::size_t size) noexcept;
 };
 
+/**
+ * Allocation blocks of a single numa node region, stored with a fixed capacity.
+ * Blocks are appended by one thread at a time (holding the allocation flag of the
+ * region) and never moved while the runtime is running; any thread can walk the
+ * blocks appended so far while blocks are appended.
+ */
+class AllocationBlockList
+{
+public:
+    AllocationBlockList() : _blocks(std::make_unique<AllocationBlock[]>(config::max_allocation_blocks())) {}
+    ~AllocationBlockList() = default;
+
+    /**
+     * @return Number of published blocks.
+     */
+    [[nodiscard]] std::uint32_t size() const noexcept { return _size.load(std::memory_order_acquire); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0U; }
+
+    [[nodiscard]] AllocationBlock &back() noexcept { return _blocks[size() - 1U]; }
+
+    [[nodiscard]] AllocationBlock *begin() noexcept { return _blocks.get(); }
+    [[nodiscard]] AllocationBlock *end() noexcept { return _blocks.get() + size(); }
+    [[nodiscard]] const AllocationBlock *begin() const noexcept { return _blocks.get(); }
+    [[nodiscard]] const AllocationBlock *end() const noexcept { return _blocks.get() + size(); }
+
+    /**
+     * Appends and publishes a block; only the thread holding the allocation flag may append.
+     * @param block Block to append.
+     * @return False, if the capacity is exhausted.
+     */
+    bool push_back(AllocationBlock &&block) noexcept
+    {
+        const auto size = _size.load(std::memory_order_relaxed);
+        if (size == config::max_allocation_blocks())
+        {
+            return false;
+        }
+
+        _blocks[size] = std::move(block);
+        _size.store(size + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Frees all blocks without allocated memory and moves the others to the front;
+     * only allowed while no thread allocates or frees.
+     */
+    void remove_free() noexcept;
+
+    /**
+     * Frees all blocks; only allowed while no thread allocates or frees.
+     */
+    void clear() noexcept;
+
+private:
+    std::unique_ptr<AllocationBlock[]> _blocks;
+    std::atomic_uint32_t _size{0U};
+};
+
 /**
  * Allocator which holds a set of allocation blocks separated
- * for each numa node region.
+ * for each numa node region. Small objects are served from
+ * per-core size classes, falling back to allocation blocks.
  */
 class Allocator
 {
@@ -146,6 +254,17 @@ public:
      */
     void defragment() noexcept;
 
+    /**
+     * Returns the memory of allocation blocks and size class spans, that stayed free for the given time, to the OS.
+     * Other than defragment(), trimming is allowed while allocating and freeing, since blocks
+     * are not moved while allocating.
+     *
+     * @param now Current time.
+     * @param unused_time Time a block has to stay free.
+     * @return Number of bytes returned to the OS.
+     */
+    std::size_t trim(std::chrono::steady_clock::time_point now, std::chrono::milliseconds unused_time) noexcept;
+
     /**
      * Releases all allocated memory.
      */
@@ -161,9 +280,38 @@ public:
      */
     [[nodiscard]] bool is_free() const noexcept;
 
+    /**
+     * Reads the memory held by the allocation blocks; any thread is allowed to read.
+     * @param numa_node_id NUMA region.
+     * @return Memory held by the allocation blocks of the given NUMA region.
+     */
+    [[nodiscard]] MemoryUsage usage(std::uint8_t numa_node_id) noexcept;
+
+    /**
+     * @param numa_node_id NUMA region.
+     * @param size_class Size class.
+     * @return Memory held by the given size class on the given NUMA region.
+     */
+    [[nodiscard]] MemoryUsage usage(const std::uint8_t numa_node_id, const std::uint8_t size_class) const noexcept
+    {
+        return _size_class_allocator.usage(numa_node_id, size_class);
+    }
+
+    /**
+     * @param numa_node_id NUMA region.
+     * @return Number of allocations refused, because the hard limit of the NUMA region was reached.
+     */
+    [[nodiscard]] std::uint64_t count_refused_allocations(const std::uint8_t numa_node_id) const noexcept
+    {
+        return _count_refused_allocations[numa_node_id].value().load(std::memory_order_relaxed);
+    }
+
 private:
+    // Per-core size classes for small objects.
+    SizeClassAllocator _size_class_allocator;
+
     // Allocation blocks per numa node region.
-    std::array<std::vector<AllocationBlock>, config::max_numa_nodes()> _numa_allocation_blocks;
+    std::array<AllocationBlockList, config::max_numa_nodes()> _numa_allocation_blocks;
 
     // Allocation flags, used for synchronization when allocating, per numa node region.
     std::array<util::aligned_t<std::atomic<bool>>, config::max_numa_nodes()> _numa_allocation_flags;
@@ -171,15 +319,29 @@ private:
     // Sequence for block allocation per numa node region.
     std::array<util::aligned_t<std::atomic_uint32_t>, config::max_numa_nodes()> _next_allocation_id;
 
+    // Allocations refused because of the hard limit per numa node region.
+    std::array<util::aligned_t<std::atomic_uint64_t>, config::max_numa_nodes()> _count_refused_allocations;
+
     /**
      * Allocates (thread-safe) a block of fresh memory
      * @param numa_node_id
      * @param size
      * @param blocks
      * @param flag
+     * @return False, if the global heap could not provide the memory.
      */
-    void allocate_new_block(std::uint8_t numa_node_id, std::size_t size, std::vector<AllocationBlock> &blocks,
+    bool allocate_new_block(std::uint8_t numa_node_id, std::size_t size, AllocationBlockList &blocks,
                             std::atomic<bool> &flag);
+
+    /**
+     * Allocates from any block of the given list, starting at the youngest.
+     * @param blocks Allocation blocks of a numa node region.
+     * @param alignment Requested alignment.
+     * @param size Requested size.
+     * @return Pointer to the allocated memory, nullptr if no block has enough free space.
+     */
+    static void *allocate_from_any_block(AllocationBlockList &blocks, std::size_t alignment,
+                                         std::size_t size) noexcept;
 };
 
 } // namespace mx::memory::dynamic
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "config.h"
 #include "global_heap.h"
 #include "task_allocator_interface.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstdint>
@@ -71,23 +72,16 @@ public:
 
     explicit ProcessorHeap(const std::uint8_t numa_node_id) noexcept : _numa_node_id(numa_node_id)
     {
-        _allocated_chunks.reserve(1024);
-        fill_buffer<true>();
+        _allocated_regions.reserve(8U);
+        fill_buffer();
     }
 
     ~ProcessorHeap() noexcept
     {
-        for (const auto allocated_chunk : _allocated_chunks)
+        // Regions are returned as they were allocated, huge page mappings can not be split.
+        for (auto *allocated_region : _allocated_regions)
         {
-            GlobalHeap::free(static_cast<void *>(allocated_chunk), Chunk::size());
-        }
-
-        for (const auto free_chunk : _free_chunk_buffer)
-        {
-            if (static_cast<bool>(free_chunk))
-            {
-                GlobalHeap::free(static_cast<void *>(free_chunk), Chunk::size());
-            }
+            GlobalHeap::free(allocated_region, Chunk::size() * CHUNKS, _numa_node_id);
         }
     }
 
@@ -98,7 +92,11 @@ public:
         other._free_chunk_buffer.fill(Chunk{});
         _next_free_chunk.store(other._next_free_chunk.load());
         _fill_buffer_flag.store(other._fill_buffer_flag.load());
-        _allocated_chunks = std::move(other._allocated_chunks);
+        _count_chunks.store(other._count_chunks.exchange(0U));
+        _allocated_regions = std::move(other._allocated_regions);
+        _regions = other._regions;
+        _count_regions.store(other._count_regions.exchange(0U));
+        _returned_objects.store(other._returned_objects.exchange(nullptr));
         return *this;
     }
 
@@ -126,7 +124,7 @@ public:
         const auto can_fill = _fill_buffer_flag.compare_exchange_strong(expect, true);
         if (can_fill)
         {
-            fill_buffer<false>();
+            fill_buffer();
             _fill_buffer_flag = false;
         }
         else
@@ -140,10 +138,80 @@ public:
         return allocate();
     }
 
+    /**
+     * @param pointer Pointer to a memory object.
+     * @return True, if the object was allocated from memory of this ProcessorHeap.
+     */
+    [[nodiscard]] bool contains(const void *pointer) const noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+        const auto count_regions = _count_regions.load(std::memory_order_acquire);
+        for (auto i = 0U; i < count_regions; ++i)
+        {
+            if (address - _regions[i] < Chunk::size() * CHUNKS)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Hands a list of objects, freed on cores of other NUMA nodes,
+     * back to this ProcessorHeap; any thread is allowed to return.
+     *
+     * @param first First object of the list.
+     * @param last Last object of the list.
+     */
+    void give_back(FreeHeader *first, FreeHeader *last) noexcept
+    {
+        auto *returned_objects = _returned_objects.load(std::memory_order_relaxed);
+        do
+        {
+            last->next(returned_objects);
+        } while (_returned_objects.compare_exchange_weak(returned_objects, first, std::memory_order_release,
+                                                         std::memory_order_relaxed) == false);
+    }
+
+    /**
+     * Takes all objects handed back by cores of other NUMA nodes.
+     *
+     * @return List of the objects, nullptr if there is none.
+     */
+    [[nodiscard]] FreeHeader *take_returned() noexcept
+    {
+        if (_returned_objects.load(std::memory_order_relaxed) == nullptr)
+        {
+            return nullptr;
+        }
+
+        return _returned_objects.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    /**
+     * @return Memory taken from the global heap and chunks handed out to the cores.
+     */
+    [[nodiscard]] MemoryUsage usage() const noexcept
+    {
+        const auto count_chunks = _count_chunks.load(std::memory_order_relaxed);
+        if (count_chunks == 0U)
+        {
+            return MemoryUsage{};
+        }
+
+        const auto count_buffered_chunks =
+            CHUNKS - std::min(std::uint32_t(_next_free_chunk.load(std::memory_order_relaxed)), CHUNKS);
+        return MemoryUsage{count_chunks * Chunk::size(), (count_chunks - count_buffered_chunks) * Chunk::size(), 0U};
+    }
+
 private:
     // Size of the internal chunk buffer.
     inline static constexpr auto CHUNKS = 128U;
 
+    // Number of memory regions (each holding CHUNKS chunks) tracked to find the origin of objects.
+    inline static constexpr auto REGIONS = 64U;
+
     // ID of the NUMA node of this ProcessorHeap.
     std::uint8_t _numa_node_id{std::numeric_limits<std::uint8_t>::max()};
 
@@ -156,30 +224,42 @@ private:
     // Flag, used for allocation from the global Heap for mutual exclusion.
     std::atomic_bool _fill_buffer_flag{false};
 
-    // List of all allocated chunks, they will be freed later.
-    std::vector<Chunk> _allocated_chunks;
+    // List of all memory regions taken from the global heap, they will be freed later.
+    std::vector<void *> _allocated_regions;
+
+    // Number of chunks taken from the global heap.
+    std::atomic_uint64_t _count_chunks{0U};
+
+    // Start of the memory regions taken from the global heap; objects of
+    // further regions are not identified and stay at the freeing core.
+    std::array<std::uintptr_t, REGIONS> _regions{};
+    std::atomic_uint32_t _count_regions{0U};
+
+    // Objects handed back by cores of other NUMA nodes.
+    alignas(64) std::atomic<FreeHeader *> _returned_objects{nullptr};
 
     /**
      * Allocates a very big chunk from the GlobalHeap and
      * splits it into smaller chunks to store them in the
      * internal buffer.
      */
-    template <bool IS_FIRST = false> void fill_buffer() noexcept
+    void fill_buffer() noexcept
     {
-        if constexpr (IS_FIRST == false)
-        {
-            for (const auto &chunk : _free_chunk_buffer)
-            {
-                _allocated_chunks.push_back(chunk);
-            }
-        }
-
         auto *heap_memory = GlobalHeap::allocate(_numa_node_id, Chunk::size() * _free_chunk_buffer.size());
+        _allocated_regions.push_back(heap_memory);
         auto heap_memory_address = reinterpret_cast<std::uintptr_t>(heap_memory);
         for (auto i = 0U; i < _free_chunk_buffer.size(); ++i)
         {
             _free_chunk_buffer[i] = Chunk(reinterpret_cast<void *>(heap_memory_address + (i * Chunk::size())));
         }
+        _count_chunks.fetch_add(_free_chunk_buffer.size(), std::memory_order_relaxed);
+
+        const auto count_regions = _count_regions.load(std::memory_order_relaxed);
+        if (count_regions < REGIONS)
+        {
+            _regions[count_regions] = heap_memory_address;
+            _count_regions.store(count_regions + 1U, std::memory_order_release);
+        }
 
         _next_free_chunk.store(0U);
     }
@@ -187,17 +267,36 @@ private:
 
 /**
  * The CoreHeap represents the allocator on a single core.
- * By this, allocations are latch-free.
+ * By this, allocations are latch-free. Objects allocated on
+ * other NUMA nodes are collected and handed back to the
+ * ProcessorHeap of their node in batches.
  */
 template <std::size_t S> class alignas(64) CoreHeap
 {
 public:
-    explicit CoreHeap(ProcessorHeap *processor_heap) noexcept : _processor_heap(processor_heap) { fill_buffer(); }
+    CoreHeap(ProcessorHeap *processor_heaps, const std::uint8_t numa_node_id) noexcept
+        : _processor_heaps(processor_heaps), _processor_heap(&processor_heaps[numa_node_id])
+    {
+        fill_buffer();
+    }
 
     CoreHeap() noexcept = default;
 
     ~CoreHeap() noexcept = default;
 
+    CoreHeap &operator=(CoreHeap &&other) noexcept
+    {
+        _processor_heaps = other._processor_heaps;
+        _processor_heap = other._processor_heap;
+        _first = std::exchange(other._first, nullptr);
+        _remote_batches = std::exchange(other._remote_batches, {});
+        for (auto numa_node_id = 0U; numa_node_id < _count_cross_node_frees.size(); ++numa_node_id)
+        {
+            _count_cross_node_frees[numa_node_id].store(other._count_cross_node_frees[numa_node_id].exchange(0U));
+        }
+        return *this;
+    }
+
     /**
      * Allocates new memory from the CoreHeap.
      * When the internal buffer is empty, the CoreHeap
@@ -209,7 +308,12 @@ public:
     {
         if (empty())
         {
-            fill_buffer();
+            // Objects handed back by other NUMA nodes are used before fresh chunks.
+            _first = _processor_heap->take_returned();
+            if (empty())
+            {
+                fill_buffer();
+            }
         }
 
         auto *free_element = std::exchange(_first, _first->next());
@@ -222,15 +326,36 @@ public:
      * the next allocation will use the just freed object, which
      * may be still in the CPU cache.
      *
+     * Objects allocated on another NUMA node are collected
+     * and handed back to their node, instead.
+     *
      * @param pointer Pointer to the memory object to be freed.
      */
     void free(void *pointer) noexcept
     {
         auto *free_object = static_cast<FreeHeader *>(pointer);
+        if constexpr (config::max_numa_nodes() > 1U)
+        {
+            if (_processor_heap->contains(pointer) == false)
+            {
+                free_cross_node(free_object);
+                return;
+            }
+        }
+
         free_object->next(_first);
         _first = free_object;
     }
 
+    /**
+     * @param numa_node_id NUMA node, the objects were allocated on.
+     * @return Number of objects of the given NUMA node, freed by this CoreHeap of another node.
+     */
+    [[nodiscard]] std::uint64_t count_cross_node_frees(const std::uint8_t numa_node_id) const noexcept
+    {
+        return _count_cross_node_frees[numa_node_id].load(std::memory_order_relaxed);
+    }
+
     /**
      * Fills the buffer by asking the ProcessorHeap for more memory.
      * This is latch-free since just a single core calls this method.
@@ -259,16 +384,76 @@ public:
     }
 
 private:
+    /**
+     * Objects of another NUMA node, collected to be handed back together.
+     */
+    struct CrossNodeBatch
+    {
+        FreeHeader *first{nullptr};
+        FreeHeader *last{nullptr};
+        std::uint32_t size{0U};
+    };
+
+    // Processor heaps of all NUMA nodes.
+    ProcessorHeap *_processor_heaps{nullptr};
+
     // Processor heap to allocate new chunks.
     ProcessorHeap *_processor_heap{nullptr};
 
     // First element of the list of free memory objects.
     FreeHeader *_first{nullptr};
 
+    // Objects of other NUMA nodes, not yet handed back.
+    std::array<CrossNodeBatch, config::max_numa_nodes()> _remote_batches{};
+
+    // Objects of other NUMA nodes freed by this core, per NUMA node.
+    std::array<std::atomic_uint64_t, config::max_numa_nodes()> _count_cross_node_frees{};
+
     /**
      * @return True, when the buffer is empty.
      */
     [[nodiscard]] bool empty() const noexcept { return _first == nullptr; }
+
+    /**
+     * Adds an object of another NUMA node to the batch of that node
+     * and hands the batch back to its ProcessorHeap when full.
+     *
+     * @param free_object Object to be freed.
+     */
+    void free_cross_node(FreeHeader *free_object) noexcept
+    {
+        auto numa_node_id = std::uint8_t(0U);
+        while (numa_node_id < config::max_numa_nodes() && _processor_heaps[numa_node_id].contains(free_object) == false)
+        {
+            ++numa_node_id;
+        }
+
+        // Objects of untracked regions stay at this core.
+        if (numa_node_id == config::max_numa_nodes())
+        {
+            free_object->next(_first);
+            _first = free_object;
+            return;
+        }
+
+        auto &batch = _remote_batches[numa_node_id];
+        free_object->numa_node_id(numa_node_id);
+        free_object->next(batch.first);
+        batch.first = free_object;
+        if (batch.last == nullptr)
+        {
+            batch.last = free_object;
+        }
+
+        auto &counter = _count_cross_node_frees[numa_node_id];
+        counter.store(counter.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+
+        if (++batch.size == config::cross_node_free_batch_size())
+        {
+            _processor_heaps[numa_node_id].give_back(batch.first, batch.last);
+            batch = CrossNodeBatch{};
+        }
+    }
 };
 
 /**
@@ -290,7 +475,7 @@ public:
         for (const auto core_id : core_set)
         {
             const auto node_id = system::topology::node_id(core_id);
-            _core_heaps[core_id] = CoreHeap<S>{&_processor_heaps[node_id]};
+            _core_heaps[core_id] = CoreHeap<S>{_processor_heaps.data(), node_id};
         }
     }
 
@@ -312,6 +497,30 @@ public:
      */
     void free(const std::uint16_t core_id, void *address) noexcept override { _core_heaps[core_id].free(address); }
 
+    /**
+     * @param numa_node_id NUMA node.
+     * @return Memory held by the ProcessorHeap of the given NUMA node.
+     */
+    [[nodiscard]] MemoryUsage usage(const std::uint8_t numa_node_id) const noexcept override
+    {
+        return _processor_heaps[numa_node_id].usage();
+    }
+
+    /**
+     * @param numa_node_id NUMA node.
+     * @return Number of objects of the given NUMA node, freed by cores of other nodes.
+     */
+    [[nodiscard]] std::uint64_t count_cross_node_frees(const std::uint8_t numa_node_id) const noexcept override
+    {
+        auto count = std::uint64_t{0U};
+        for (const auto &core_heap : _core_heaps)
+        {
+            count += core_heap.count_cross_node_frees(numa_node_id);
+        }
+
+        return count;
+    }
+
 private:
     // Heap for every processor socket/NUMA region.
     std::array<ProcessorHeap, config::max_numa_nodes()> _processor_heaps;
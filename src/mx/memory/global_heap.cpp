@@ -0,0 +1,89 @@
+#include "global_heap.h"
+#include <fstream>
+#include <linux/mman.h>
+#include <sstream>
+#include <string>
+
+using namespace mx::memory;
+
+void *GlobalHeap::allocate_huge_pages(const std::uint8_t numa_node_id, const std::size_t size)
+{
+    constexpr auto huge_page_size = config::huge_page_size();
+    static_assert(huge_page_size == 0U || huge_page_size == 2UL << 20U || huge_page_size == 1UL << 30U,
+                  "Huge pages are 2 MiB or 1 GiB.");
+    const auto huge_page_aligned_size = alignment_helper::next_multiple(size, huge_page_size);
+
+    // Reserved huge pages are taken first...
+    constexpr auto huge_page_flag = huge_page_size == 1UL << 30U ? MAP_HUGE_1GB : MAP_HUGE_2MB;
+    auto *memory = ::mmap(nullptr, huge_page_aligned_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_page_flag, -1, 0);
+    if (memory != MAP_FAILED)
+    {
+        if (numa_available() >= 0)
+        {
+            numa_tonode_memory(memory, huge_page_aligned_size, numa_node_id);
+        }
+        GlobalHeap::_allocated_explicit_huge_pages.fetch_add(huge_page_aligned_size, std::memory_order_relaxed);
+        return memory;
+    }
+
+    // ... otherwise, the OS is asked for transparent huge pages, which need aligned memory.
+    auto *reserved_memory = ::mmap(nullptr, huge_page_aligned_size + huge_page_size, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved_memory == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    const auto reserved_begin = reinterpret_cast<std::uintptr_t>(reserved_memory);
+    const auto reserved_end = reserved_begin + huge_page_aligned_size + huge_page_size;
+    const auto begin = (reserved_begin + huge_page_size - 1U) & ~(huge_page_size - 1U);
+    const auto end = begin + huge_page_aligned_size;
+    if (begin > reserved_begin)
+    {
+        ::munmap(reserved_memory, begin - reserved_begin);
+    }
+    if (reserved_end > end)
+    {
+        ::munmap(reinterpret_cast<void *>(end), reserved_end - end);
+    }
+
+    memory = reinterpret_cast<void *>(begin);
+    ::madvise(memory, huge_page_aligned_size, MADV_HUGEPAGE);
+    if (numa_available() >= 0)
+    {
+        numa_tonode_memory(memory, huge_page_aligned_size, numa_node_id);
+    }
+    GlobalHeap::_allocated_transparent_huge_pages.fetch_add(huge_page_aligned_size, std::memory_order_relaxed);
+    return memory;
+}
+
+HugePageMemory GlobalHeap::huge_page_memory()
+{
+    auto huge_page_memory =
+        HugePageMemory{GlobalHeap::_allocated_explicit_huge_pages.load(std::memory_order_relaxed),
+                       GlobalHeap::_allocated_transparent_huge_pages.load(std::memory_order_relaxed), 0U, 0U};
+
+    // The OS reports the memory backed by huge pages summed over all mappings in kB.
+    auto smaps = std::ifstream{"/proc/self/smaps_rollup"};
+    auto line = std::string{};
+    while (std::getline(smaps, line))
+    {
+        auto line_stream = std::istringstream{line};
+        auto key = std::string{};
+        auto kilobytes = std::uint64_t{0U};
+        if (line_stream >> key >> kilobytes)
+        {
+            if (key == "AnonHugePages:")
+            {
+                huge_page_memory.backed_transparent += kilobytes * 1024U;
+            }
+            else if (key == "Private_Hugetlb:" || key == "Shared_Hugetlb:")
+            {
+                huge_page_memory.backed_explicit += kilobytes * 1024U;
+            }
+        }
+    }
+
+    return huge_page_memory;
+}
\ No newline at end of file
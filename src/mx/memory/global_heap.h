@@ -1,10 +1,31 @@
 #pragma once
 #include "alignment_helper.h"
+#include "config.h"
+#include "memory_usage.h"
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <numa.h>
+#include <sys/mman.h>
 
 namespace mx::memory {
+/**
+ * Memory backed by huge pages.
+ */
+struct HugePageMemory
+{
+    // Bytes allocated from reserved huge pages (hugetlbfs) since the start.
+    std::uint64_t allocated_explicit;
+
+    // Bytes allocated with a request for transparent huge pages since the start.
+    std::uint64_t allocated_transparent;
+
+    // Bytes of the process currently backed by reserved and transparent huge pages (as reported by the OS).
+    std::uint64_t backed_explicit;
+    std::uint64_t backed_transparent;
+};
+
 /**
  * The global heap represents the heap, provided by the OS.
  */
@@ -20,7 +41,14 @@ public:
      */
     static void *allocate(const std::uint8_t numa_node_id, const std::size_t size)
     {
-        return numa_alloc_onnode(size, numa_node_id);
+        auto *memory = GlobalHeap::is_huge_page_backed(size) ? GlobalHeap::allocate_huge_pages(numa_node_id, size)
+                                                             : numa_alloc_onnode(size, numa_node_id);
+        if (memory != nullptr)
+        {
+            GlobalHeap::count_reserved(numa_node_id, GlobalHeap::reserved_size(size));
+        }
+
+        return memory;
     }
 
     /**
@@ -40,7 +68,159 @@ public:
      *
      * @param memory Pointer to memory.
      * @param size Size of the allocated object.
+     * @param numa_node_id ID of the NUMA node, the memory was allocated on.
+     */
+    static void free(void *memory, const std::size_t size, const std::uint8_t numa_node_id)
+    {
+        if (GlobalHeap::is_huge_page_backed(size))
+        {
+            ::munmap(memory, GlobalHeap::reserved_size(size));
+        }
+        else
+        {
+            numa_free(memory, size);
+        }
+
+        GlobalHeap::count_released(numa_node_id, GlobalHeap::reserved_size(size));
+    }
+
+    /**
+     * Counts memory taken from the OS without the global heap (e.g., spans of size classes).
+     * @param numa_node_id ID of the NUMA node, the memory is allocated on.
+     * @param size Size of the memory.
+     */
+    static void count_reserved(const std::uint8_t numa_node_id, const std::size_t size) noexcept
+    {
+        GlobalHeap::_reserved[numa_node_id].fetch_add(size, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts memory given back to the OS without the global heap.
+     * @param numa_node_id ID of the NUMA node, the memory was allocated on.
+     * @param size Size of the memory.
+     */
+    static void count_released(const std::uint8_t numa_node_id, const std::size_t size) noexcept
+    {
+        GlobalHeap::_reserved[numa_node_id].fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    /**
+     * @param numa_node_id ID of the NUMA node.
+     * @return Bytes currently taken from the OS on the given NUMA node.
+     */
+    [[nodiscard]] static std::uint64_t reserved(const std::uint8_t numa_node_id) noexcept
+    {
+        return GlobalHeap::_reserved[numa_node_id].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the limits of the memory taken from the OS on the given NUMA node.
+     * The limits are not enforced by the global heap itself, but by allocators
+     * that can fail gracefully (e.g., the allocator for resources).
+     *
+     * @param numa_node_id ID of the NUMA node.
+     * @param limit Soft and hard limit.
+     */
+    static void limit(const std::uint8_t numa_node_id, const MemoryLimit limit) noexcept
+    {
+        GlobalHeap::_soft_limits[numa_node_id].store(limit.soft, std::memory_order_relaxed);
+        GlobalHeap::_hard_limits[numa_node_id].store(limit.hard, std::memory_order_relaxed);
+    }
+
+    /**
+     * @param numa_node_id ID of the NUMA node.
+     * @return Limits of the memory taken from the OS on the given NUMA node.
+     */
+    [[nodiscard]] static MemoryLimit limit(const std::uint8_t numa_node_id) noexcept
+    {
+        return MemoryLimit{GlobalHeap::_soft_limits[numa_node_id].load(std::memory_order_relaxed),
+                           GlobalHeap::_hard_limits[numa_node_id].load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @param numa_node_id ID of the NUMA node.
+     * @param size Size of memory to take from the OS.
+     * @return True, if taking the memory would exceed the soft limit of the NUMA node.
+     */
+    [[nodiscard]] static bool exceeds_soft_limit(const std::uint8_t numa_node_id, const std::size_t size) noexcept
+    {
+        return GlobalHeap::exceeds(GlobalHeap::_soft_limits[numa_node_id], numa_node_id, size);
+    }
+
+    /**
+     * @param numa_node_id ID of the NUMA node.
+     * @param size Size of memory to take from the OS.
+     * @return True, if taking the memory would exceed the hard limit of the NUMA node.
+     */
+    [[nodiscard]] static bool exceeds_hard_limit(const std::uint8_t numa_node_id, const std::size_t size) noexcept
+    {
+        return GlobalHeap::exceeds(GlobalHeap::_hard_limits[numa_node_id], numa_node_id, size);
+    }
+
+    /**
+     * @return Memory allocated from and backed by huge pages.
+     */
+    [[nodiscard]] static HugePageMemory huge_page_memory();
+
+private:
+    // Bytes allocated from reserved and transparent huge pages.
+    inline static std::atomic_uint64_t _allocated_explicit_huge_pages{0U};
+    inline static std::atomic_uint64_t _allocated_transparent_huge_pages{0U};
+
+    // Bytes taken from the OS per NUMA node.
+    inline static std::array<std::atomic_uint64_t, config::max_numa_nodes()> _reserved{};
+
+    // Soft and hard limits of the bytes taken from the OS per NUMA node; zero means no limit.
+    inline static std::array<std::atomic_uint64_t, config::max_numa_nodes()> _soft_limits{};
+    inline static std::array<std::atomic_uint64_t, config::max_numa_nodes()> _hard_limits{};
+
+    /**
+     * @param size Size of memory.
+     * @return True, if memory of the given size is backed by huge pages.
+     */
+    [[nodiscard]] static constexpr bool is_huge_page_backed(const std::size_t size) noexcept
+    {
+        if constexpr (config::huge_page_size() > 0U)
+        {
+            return size >= config::huge_page_size();
+        }
+
+        return false;
+    }
+
+    /**
+     * @param size Size of memory.
+     * @return Size of memory taken from the OS, rounded up to the huge page size when backed by huge pages.
+     */
+    [[nodiscard]] static constexpr std::size_t reserved_size(const std::size_t size) noexcept
+    {
+        if constexpr (config::huge_page_size() > 0U)
+        {
+            if (size >= config::huge_page_size())
+            {
+                return alignment_helper::next_multiple(size, config::huge_page_size());
+            }
+        }
+
+        return size;
+    }
+
+    [[nodiscard]] static bool exceeds(const std::atomic_uint64_t &limit, const std::uint8_t numa_node_id,
+                                      const std::size_t size) noexcept
+    {
+        const auto max = limit.load(std::memory_order_relaxed);
+        const auto reserved = GlobalHeap::reserved(numa_node_id);
+        return max > 0U && (reserved > max || size > max - reserved);
+    }
+
+    /**
+     * Allocates memory backed by huge pages; falls back to transparent
+     * huge pages when no huge pages are reserved.
+     *
+     * @param numa_node_id ID of the NUMA node, the memory should allocated on.
+     * @param size Size of the memory, rounded up to the huge page size.
+     * @return Pointer to allocated memory, nullptr if no memory is left.
      */
-    static void free(void *memory, const std::size_t size) { numa_free(memory, size); }
+    static void *allocate_huge_pages(std::uint8_t numa_node_id, std::size_t size);
 };
 } // namespace mx::memory
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "config.h"
+#include <array>
+#include <cstdint>
+
+namespace mx::memory {
+/**
+ * Memory held by an allocator on a single NUMA node.
+ */
+struct MemoryUsage
+{
+    // Bytes taken from the OS.
+    std::uint64_t reserved{0U};
+
+    // Bytes handed out and not freed, including headers and padding.
+    std::uint64_t in_use{0U};
+
+    // Free bytes that can not serve every request, e.g., free objects of a size class
+    // or free space of an allocation block beside its largest free element.
+    std::uint64_t fragmented{0U};
+
+    MemoryUsage &operator+=(const MemoryUsage &other) noexcept
+    {
+        reserved += other.reserved;
+        in_use += other.in_use;
+        fragmented += other.fragmented;
+        return *this;
+    }
+};
+
+/**
+ * Limits of the memory taken from the OS per NUMA node; zero means no limit.
+ */
+struct MemoryLimit
+{
+    // Beyond the soft limit, free memory is reused before new memory is taken.
+    std::uint64_t soft{0U};
+
+    // Beyond the hard limit, allocations of resources fail (returning nullptr).
+    std::uint64_t hard{0U};
+};
+
+/**
+ * Memory held on a single NUMA node, split by allocator.
+ */
+struct NumaMemoryUsage
+{
+    std::uint8_t numa_node_id{0U};
+
+    // Bytes taken from the OS via the global heap, including tasks, resources, and internal structures.
+    std::uint64_t global_heap{0U};
+
+    // Limits of the bytes taken from the OS.
+    MemoryLimit limit;
+
+    // Allocations of resources refused because of the hard limit.
+    std::uint64_t refused_allocations{0U};
+
+    // Memory of tasks and coroutine frames (in-use counts chunks handed to the cores).
+    MemoryUsage tasks;
+
+    // Tasks and coroutine frames of this NUMA node, freed by cores of other nodes.
+    std::uint64_t cross_node_task_frees{0U};
+
+    // Resources allocated from allocation blocks.
+    MemoryUsage allocation_blocks;
+
+    // Resources allocated from size classes, per size class.
+    std::array<MemoryUsage, config::count_size_classes()> size_classes{};
+};
+} // namespace mx::memory
\ No newline at end of file
@@ -39,6 +39,12 @@ void EpochManager::enter_epoch_periodically()
             this->reclaim_epoch_garbage();
         }
 
+        // Return memory of allocation blocks that stayed free to the OS.
+        if constexpr (config::trim_unused_memory_after().count() > 0U)
+        {
+            this->_allocator.trim(std::chrono::steady_clock::now(), config::trim_unused_memory_after());
+        }
+
         // Wait some time until next epoch.
         std::this_thread::sleep_for(config::epoch_interval()); // NOLINT: sleep_for seems to crash clang-tidy
     }
@@ -0,0 +1,430 @@
+#include "size_class_allocator.h"
+#include "global_heap.h"
+#include <algorithm>
+#include <mx/system/topology.h>
+#include <numa.h>
+#include <sys/mman.h>
+#include <utility>
+
+using namespace mx::memory::dynamic;
+
+SizeClassRegion::~SizeClassRegion() noexcept
+{
+    if (this->_begin != 0U)
+    {
+        this->release();
+        ::munmap(reinterpret_cast<void *>(this->_begin), config::size_class_region_size());
+    }
+}
+
+bool SizeClassRegion::reserve(const std::uint8_t numa_node_id) noexcept
+{
+    // Only address space is reserved; the OS backs pages when they are touched.
+    auto *memory = ::mmap(nullptr, config::size_class_region_size(), PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    if (numa_available() >= 0)
+    {
+        numa_tonode_memory(memory, config::size_class_region_size(), numa_node_id);
+    }
+
+    // Huge pages can not be reserved up front; spans are backed by transparent huge pages instead.
+    if constexpr (config::huge_page_size() > 0U)
+    {
+        ::madvise(memory, config::size_class_region_size(), MADV_HUGEPAGE);
+    }
+
+    this->_spans = std::make_unique_for_overwrite<SpanInfo[]>(config::size_class_region_size() /
+                                                             config::size_class_span_size());
+    this->_begin = reinterpret_cast<std::uintptr_t>(memory);
+    this->_numa_node_id = numa_node_id;
+    return true;
+}
+
+std::uintptr_t SizeClassRegion::allocate_span(const std::uint16_t core_id, const std::uint8_t size_class) noexcept
+{
+    constexpr auto max_spans = config::size_class_region_size() / config::size_class_span_size();
+    if (this->_begin == 0U || this->_count_spans.load(std::memory_order_relaxed) >= max_spans ||
+        GlobalHeap::exceeds_hard_limit(this->_numa_node_id, config::size_class_span_size()))
+    {
+        return 0U;
+    }
+
+    const auto span_id = this->_count_spans.fetch_add(1U, std::memory_order_relaxed);
+    if (span_id >= max_spans)
+    {
+        return 0U;
+    }
+
+    // Objects are handed to other threads with synchronization, publishing the span information.
+    auto &span = this->_spans[span_id];
+    span.core_id = core_id;
+    span.size_class = size_class;
+    span.is_trimmed = false;
+    span.next_span = SizeClassRegion::no_span();
+    span.count_free = 0U;
+    span.unused_since = std::chrono::steady_clock::time_point::min();
+    this->_count_size_class_spans[size_class].fetch_add(1U, std::memory_order_relaxed);
+    GlobalHeap::count_reserved(this->_numa_node_id, config::size_class_span_size());
+    return this->span_address(std::uint32_t(span_id));
+}
+
+bool SizeClassRegion::reuse_span(const std::uint32_t span_id) noexcept
+{
+    if (GlobalHeap::exceeds_hard_limit(this->_numa_node_id, config::size_class_span_size()))
+    {
+        return false;
+    }
+
+    auto &span = this->_spans[span_id];
+    span.is_trimmed = false;
+    span.unused_since = std::chrono::steady_clock::time_point::min();
+    this->_count_size_class_spans[span.size_class].fetch_add(1U, std::memory_order_relaxed);
+    GlobalHeap::count_reserved(this->_numa_node_id, config::size_class_span_size());
+    return true;
+}
+
+void SizeClassRegion::trim_span(const std::uint32_t span_id) noexcept
+{
+    auto &span = this->_spans[span_id];
+    ::madvise(reinterpret_cast<void *>(this->span_address(span_id)), config::size_class_span_size(), MADV_DONTNEED);
+    this->_count_size_class_spans[span.size_class].fetch_sub(1U, std::memory_order_relaxed);
+    GlobalHeap::count_released(this->_numa_node_id, config::size_class_span_size());
+}
+
+void SizeClassRegion::release() noexcept
+{
+    const auto count_spans = std::min(this->_count_spans.load(std::memory_order_relaxed),
+                                      config::size_class_region_size() / config::size_class_span_size());
+    if (count_spans > 0U)
+    {
+        ::madvise(reinterpret_cast<void *>(this->_begin), count_spans * config::size_class_span_size(),
+                  MADV_DONTNEED);
+    }
+    this->_count_spans.store(0U, std::memory_order_relaxed);
+
+    for (auto &count_size_class_spans : this->_count_size_class_spans)
+    {
+        const auto count_released_spans = count_size_class_spans.exchange(0U, std::memory_order_relaxed);
+        GlobalHeap::count_released(this->_numa_node_id, count_released_spans * config::size_class_span_size());
+    }
+}
+
+void Magazine::clear() noexcept
+{
+    for (auto &lists : this->_lists)
+    {
+        lists.fill(List{});
+    }
+
+    for (auto &remote_lists : this->_remote_lists)
+    {
+        for (auto &remote_list : remote_lists)
+        {
+            remote_list.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    for (auto *counters : {&this->_count_allocated, &this->_count_freed, &this->_count_remote_freed})
+    {
+        for (auto &size_class_counters : *counters)
+        {
+            for (auto &counter : size_class_counters)
+            {
+                counter.store(0U, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+SizeClassAllocator::SizeClassAllocator() noexcept
+{
+    const auto count_numa_nodes = std::min(std::uint32_t(system::topology::max_node_id()) + 1U,
+                                           std::uint32_t(config::max_numa_nodes()));
+    for (auto numa_node_id = 0U; numa_node_id < count_numa_nodes; ++numa_node_id)
+    {
+        this->_regions[numa_node_id].reserve(std::uint8_t(numa_node_id));
+    }
+}
+
+void *SizeClassAllocator::allocate(const std::uint8_t numa_node_id, const std::uint8_t size_class) noexcept
+{
+    // Threads not owning a magazine (or sharing the core with its owner) use allocation blocks.
+    const auto core_id = system::topology::core_id();
+    if (core_id >= this->_magazines.size() || this->_magazines[core_id].try_lock() == false)
+    {
+        return nullptr;
+    }
+
+    auto &magazine = this->_magazines[core_id];
+    auto &list = magazine.list(numa_node_id, size_class);
+    if (list.first == nullptr)
+    {
+        list.first = magazine.take_remote(numa_node_id, size_class);
+    }
+
+    void *object = nullptr;
+    if (list.first != nullptr)
+    {
+        object = std::exchange(list.first, list.first->next);
+    }
+    else
+    {
+        // Carve the next object from the current span, fetch a new span when exhausted.
+        if (list.span_next == list.span_end)
+        {
+            const auto span = this->next_span(list, numa_node_id, core_id, size_class);
+            list.span_next = span;
+            list.span_end = span != 0U ? span + config::size_class_span_size() : 0U;
+        }
+
+        if (list.span_next != 0U)
+        {
+            object = reinterpret_cast<void *>(list.span_next);
+            list.span_next += SizeClassAllocator::object_size(size_class);
+        }
+    }
+
+    if (object != nullptr)
+    {
+        magazine.allocated(numa_node_id, size_class);
+    }
+    magazine.unlock();
+
+    return object;
+}
+
+bool SizeClassAllocator::free(void *pointer) noexcept
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    for (auto numa_node_id = std::uint8_t(0U); numa_node_id < this->_regions.size(); ++numa_node_id)
+    {
+        const auto &region = this->_regions[numa_node_id];
+        if (region.contains(address))
+        {
+            const auto &span = region.span(address);
+            auto *object = static_cast<FreeObject *>(pointer);
+            auto &magazine = this->_magazines[span.core_id];
+
+            // The object is freed by the owning core: Prepend it to the local list, it may be still cached.
+            if (span.core_id == system::topology::core_id() && magazine.try_lock())
+            {
+                auto &list = magazine.list(numa_node_id, span.size_class);
+                object->next = list.first;
+                list.first = object;
+                magazine.freed(numa_node_id, span.size_class);
+                magazine.unlock();
+            }
+            else
+            {
+                magazine.free_remote(numa_node_id, span.size_class, object);
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SizeClassAllocator::is_free() const noexcept
+{
+    auto count_used = std::int64_t{0};
+    for (const auto &magazine : this->_magazines)
+    {
+        count_used += magazine.count_used();
+    }
+
+    return count_used == 0;
+}
+
+mx::memory::MemoryUsage SizeClassAllocator::usage(const std::uint8_t numa_node_id,
+                                                  const std::uint8_t size_class) const noexcept
+{
+    auto count_used = std::int64_t{0};
+    for (const auto &magazine : this->_magazines)
+    {
+        count_used += magazine.count_used(numa_node_id, size_class);
+    }
+
+    // Counters are read while objects are allocated and freed; objects may be counted as freed, only.
+    const auto reserved = this->_regions[numa_node_id].count_spans(size_class) * config::size_class_span_size();
+    const auto in_use = std::min(std::uint64_t(std::max(count_used, std::int64_t{0})) *
+                                     SizeClassAllocator::object_size(size_class),
+                                 reserved);
+    return MemoryUsage{reserved, in_use, reserved - in_use};
+}
+
+std::uintptr_t SizeClassAllocator::next_span(Magazine::List &list, const std::uint8_t numa_node_id,
+                                             const std::uint16_t core_id, const std::uint8_t size_class) noexcept
+{
+    auto &region = this->_regions[numa_node_id];
+
+    auto span = std::uintptr_t{0U};
+    if (list.trimmed_spans != SizeClassRegion::no_span())
+    {
+        const auto span_id = list.trimmed_spans;
+        if (region.reuse_span(span_id))
+        {
+            list.trimmed_spans = std::exchange(region.span_info(span_id).next_span, list.spans);
+            list.spans = span_id;
+            span = region.span_address(span_id);
+        }
+    }
+    else
+    {
+        span = region.allocate_span(core_id, size_class);
+        if (span != 0U)
+        {
+            const auto span_id = region.span_id(span);
+            region.span_info(span_id).next_span = std::exchange(list.spans, span_id);
+        }
+    }
+
+    return span;
+}
+
+std::size_t SizeClassAllocator::trim(const std::chrono::steady_clock::time_point now,
+                                     const std::chrono::milliseconds unused_time) noexcept
+{
+    auto trimmed_size = std::size_t{0U};
+    for (auto &magazine : this->_magazines)
+    {
+        // Do not delay allocations; the magazine is trimmed next time.
+        if (magazine.try_lock() == false)
+        {
+            continue;
+        }
+
+        for (auto numa_node_id = std::uint8_t(0U); numa_node_id < this->_regions.size(); ++numa_node_id)
+        {
+            for (auto size_class = std::uint8_t(0U); size_class < config::count_size_classes(); ++size_class)
+            {
+                trimmed_size += this->trim(magazine, numa_node_id, size_class, now, unused_time);
+            }
+        }
+
+        magazine.unlock();
+    }
+
+    return trimmed_size;
+}
+
+std::size_t SizeClassAllocator::trim(Magazine &magazine, const std::uint8_t numa_node_id,
+                                     const std::uint8_t size_class, const std::chrono::steady_clock::time_point now,
+                                     const std::chrono::milliseconds unused_time) noexcept
+{
+    auto &list = magazine.list(numa_node_id, size_class);
+    if (list.spans == SizeClassRegion::no_span())
+    {
+        return 0U;
+    }
+
+    auto &region = this->_regions[numa_node_id];
+
+    // Objects freed by other cores are taken, objects freed meanwhile keep their span in use.
+    auto *remote_object = magazine.take_remote(numa_node_id, size_class);
+    while (remote_object != nullptr)
+    {
+        auto *object = std::exchange(remote_object, remote_object->next);
+        object->next = std::exchange(list.first, object);
+    }
+
+    auto span_id = list.spans;
+    while (span_id != SizeClassRegion::no_span())
+    {
+        auto &span = region.span_info(span_id);
+        span.count_free = 0U;
+        span_id = span.next_span;
+    }
+
+    for (auto *object = list.first; object != nullptr; object = object->next)
+    {
+        ++region.span_info(region.span_id(reinterpret_cast<std::uintptr_t>(object))).count_free;
+    }
+
+    // Spans are free when all objects carved from them are free.
+    const auto object_size = SizeClassAllocator::object_size(size_class);
+    auto count_trimmed = 0U;
+    auto *next_span_id = &list.spans;
+    while (*next_span_id != SizeClassRegion::no_span())
+    {
+        auto &span = region.span_info(*next_span_id);
+        const auto span_address = region.span_address(*next_span_id);
+        const auto is_carved = list.span_end == span_address + config::size_class_span_size();
+        const auto count_carved = is_carved ? (list.span_next - span_address) / object_size
+                                            : config::size_class_span_size() / object_size;
+
+        if (span.count_free < count_carved)
+        {
+            span.unused_since = std::chrono::steady_clock::time_point::min();
+        }
+        else if (span.unused_since == std::chrono::steady_clock::time_point::min())
+        {
+            span.unused_since = now;
+        }
+        else if (now - span.unused_since >= unused_time)
+        {
+            if (is_carved)
+            {
+                list.span_next = 0U;
+                list.span_end = 0U;
+            }
+
+            // Move the span to the trimmed spans, it is reused before fresh spans are handed out.
+            span.is_trimmed = true;
+            ++count_trimmed;
+            const auto trimmed_span_id = std::exchange(*next_span_id, span.next_span);
+            span.next_span = std::exchange(list.trimmed_spans, trimmed_span_id);
+            continue;
+        }
+
+        next_span_id = &span.next_span;
+    }
+
+    if (count_trimmed == 0U)
+    {
+        return 0U;
+    }
+
+    // Objects of trimmed spans are no longer handed out; unlinked before their memory is returned.
+    auto **object = &list.first;
+    while (*object != nullptr)
+    {
+        if (region.span(reinterpret_cast<std::uintptr_t>(*object)).is_trimmed)
+        {
+            *object = (*object)->next;
+        }
+        else
+        {
+            object = &(*object)->next;
+        }
+    }
+
+    // Trimmed spans were prepended to the trimmed spans of the list.
+    auto trimmed_span_id = list.trimmed_spans;
+    for (auto i = 0U; i < count_trimmed; ++i)
+    {
+        region.trim_span(trimmed_span_id);
+        trimmed_span_id = region.span_info(trimmed_span_id).next_span;
+    }
+
+    return count_trimmed * config::size_class_span_size();
+}
+
+void SizeClassAllocator::release() noexcept
+{
+    for (auto &magazine : this->_magazines)
+    {
+        magazine.clear();
+    }
+
+    for (auto &region : this->_regions)
+    {
+        region.release();
+    }
+}
\ No newline at end of file
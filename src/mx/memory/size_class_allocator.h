@@ -0,0 +1,421 @@
+#pragma once
+
+#include "config.h"
+#include "memory_usage.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mx/tasking/config.h>
+
+namespace mx::memory::dynamic {
+/**
+ * Free object within a size class, linking the next free object.
+ */
+struct FreeObject
+{
+    FreeObject *next;
+};
+
+/**
+ * Information about a span: The core owning the objects and their size class.
+ * All but the owner and size class are written while the magazine of the owning core is locked.
+ */
+struct SpanInfo
+{
+    std::uint16_t core_id;
+    std::uint8_t size_class;
+
+    // The memory of the span was returned to the OS.
+    bool is_trimmed;
+
+    // Next span of the same core, NUMA region, and size class.
+    std::uint32_t next_span;
+
+    // Free objects of the span, counted while trimming.
+    std::uint32_t count_free;
+
+    // Time the span was found free first; min() while objects are in use.
+    std::chrono::steady_clock::time_point unused_since;
+};
+
+/**
+ * Virtual memory of a single NUMA region, reserved once and handed
+ * out in spans. Every span holds objects of a single size class.
+ * Physical memory is allocated by the OS when objects are touched.
+ */
+class SizeClassRegion
+{
+public:
+    SizeClassRegion() noexcept = default;
+    ~SizeClassRegion() noexcept;
+
+    /**
+     * Reserves the virtual memory on the given NUMA node.
+     * @param numa_node_id NUMA node.
+     * @return True, if the memory could be reserved.
+     */
+    bool reserve(std::uint8_t numa_node_id) noexcept;
+
+    /**
+     * @param address Address of an object.
+     * @return True, if the object is located in this region.
+     */
+    [[nodiscard]] bool contains(const std::uintptr_t address) const noexcept
+    {
+        return this->_begin != 0U && address - this->_begin < config::size_class_region_size();
+    }
+
+    /**
+     * @return Id marking the end of a list of spans.
+     */
+    [[nodiscard]] static constexpr std::uint32_t no_span() noexcept
+    {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+
+    /**
+     * Hands out a fresh span.
+     * @param core_id Core owning the objects of the span.
+     * @param size_class Size class of the objects.
+     * @return Start of the span, zero if the region is exhausted or the hard limit of the NUMA node is reached.
+     */
+    std::uintptr_t allocate_span(std::uint16_t core_id, std::uint8_t size_class) noexcept;
+
+    /**
+     * Hands out a trimmed span again, keeping its owner and size class; the OS backs the pages when touched.
+     * @param span_id Id of the trimmed span.
+     * @return True, if the hard limit of the NUMA node is not reached.
+     */
+    bool reuse_span(std::uint32_t span_id) noexcept;
+
+    /**
+     * Returns the memory of a span to the OS; the caller has to guarantee that no object is in use
+     * and has to mark the span as trimmed.
+     * @param span_id Id of the span.
+     */
+    void trim_span(std::uint32_t span_id) noexcept;
+
+    /**
+     * @param address Address located in this region.
+     * @return Id of the span holding the address.
+     */
+    [[nodiscard]] std::uint32_t span_id(const std::uintptr_t address) const noexcept
+    {
+        return std::uint32_t((address - this->_begin) / config::size_class_span_size());
+    }
+
+    /**
+     * @param span_id Id of a span.
+     * @return Start of the span.
+     */
+    [[nodiscard]] std::uintptr_t span_address(const std::uint32_t span_id) const noexcept
+    {
+        return this->_begin + span_id * config::size_class_span_size();
+    }
+
+    /**
+     * @param span_id Id of a span.
+     * @return Information about the span.
+     */
+    [[nodiscard]] SpanInfo &span_info(const std::uint32_t span_id) noexcept { return this->_spans[span_id]; }
+
+    /**
+     * @param address Address of an object located in this region.
+     * @return Information about the span of the object.
+     */
+    [[nodiscard]] const SpanInfo &span(const std::uintptr_t address) const noexcept
+    {
+        return this->_spans[this->span_id(address)];
+    }
+
+    /**
+     * @param size_class Size class.
+     * @return Number of spans handed out for objects of the given size class.
+     */
+    [[nodiscard]] std::uint64_t count_spans(const std::uint8_t size_class) const noexcept
+    {
+        return this->_count_size_class_spans[size_class].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns all spans; the caller has to guarantee that no object is in use.
+     */
+    void release() noexcept;
+
+private:
+    // Start of the reserved memory, zero if not reserved.
+    std::uintptr_t _begin{0U};
+
+    // NUMA node the memory is reserved on.
+    std::uint8_t _numa_node_id{0U};
+
+    // Number of spans handed out.
+    std::atomic_uint64_t _count_spans{0U};
+
+    // Number of spans handed out per size class.
+    std::array<std::atomic_uint64_t, config::count_size_classes()> _count_size_class_spans{};
+
+    // Information of every span.
+    std::unique_ptr<SpanInfo[]> _spans;
+};
+
+/**
+ * Free objects of all size classes on all NUMA regions, owned by a single core.
+ * The owning core allocates and frees without atomic read-modify-write,
+ * guarded by a (uncontended) flag against other threads running on the same core.
+ * Other cores hand freed objects back via lock-free lists.
+ */
+class alignas(64) Magazine
+{
+public:
+    /**
+     * Free objects, the span currently carved into objects, and all spans held.
+     */
+    struct List
+    {
+        FreeObject *first{nullptr};
+        std::uintptr_t span_next{0U};
+        std::uintptr_t span_end{0U};
+
+        // Spans handed out and spans returned to the OS, linked via SpanInfo::next_span.
+        std::uint32_t spans{SizeClassRegion::no_span()};
+        std::uint32_t trimmed_spans{SizeClassRegion::no_span()};
+    };
+
+    constexpr Magazine() noexcept = default;
+    ~Magazine() noexcept = default;
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        return this->_is_locked.exchange(true, std::memory_order_acquire) == false;
+    }
+    void unlock() noexcept { this->_is_locked.store(false, std::memory_order_release); }
+
+    [[nodiscard]] List &list(const std::uint8_t numa_node_id, const std::uint8_t size_class) noexcept
+    {
+        return this->_lists[numa_node_id][size_class];
+    }
+
+    /**
+     * Hands a freed object back to this magazine; any thread is allowed to free.
+     * @param numa_node_id NUMA region of the object.
+     * @param size_class Size class of the object.
+     * @param object Freed object.
+     */
+    void free_remote(const std::uint8_t numa_node_id, const std::uint8_t size_class, FreeObject *object) noexcept
+    {
+        auto &remote_list = this->_remote_lists[numa_node_id][size_class];
+        object->next = remote_list.load(std::memory_order_relaxed);
+        while (remote_list.compare_exchange_weak(object->next, object, std::memory_order_release,
+                                                 std::memory_order_relaxed) == false)
+        {
+        }
+        this->_count_remote_freed[numa_node_id][size_class].fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    /**
+     * Takes all objects freed by other cores; called by the owner while locked.
+     * @param numa_node_id NUMA region of the objects.
+     * @param size_class Size class of the objects.
+     * @return List of the freed objects.
+     */
+    [[nodiscard]] FreeObject *take_remote(const std::uint8_t numa_node_id, const std::uint8_t size_class) noexcept
+    {
+        auto &remote_list = this->_remote_lists[numa_node_id][size_class];
+        if (remote_list.load(std::memory_order_relaxed) == nullptr)
+        {
+            return nullptr;
+        }
+
+        return remote_list.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    /**
+     * Counts an allocated or locally freed object; called by the owner while locked.
+     */
+    void allocated(const std::uint8_t numa_node_id, const std::uint8_t size_class) noexcept
+    {
+        Magazine::increment(this->_count_allocated[numa_node_id][size_class]);
+    }
+    void freed(const std::uint8_t numa_node_id, const std::uint8_t size_class) noexcept
+    {
+        Magazine::increment(this->_count_freed[numa_node_id][size_class]);
+    }
+
+    /**
+     * @param numa_node_id NUMA region of the objects.
+     * @param size_class Size class of the objects.
+     * @return Number of objects allocated from this magazine and not freed.
+     */
+    [[nodiscard]] std::int64_t count_used(const std::uint8_t numa_node_id, const std::uint8_t size_class) const noexcept
+    {
+        return std::int64_t(this->_count_allocated[numa_node_id][size_class].load(std::memory_order_relaxed)) -
+               std::int64_t(this->_count_freed[numa_node_id][size_class].load(std::memory_order_relaxed)) -
+               std::int64_t(this->_count_remote_freed[numa_node_id][size_class].load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @return Number of objects allocated from this magazine and not freed.
+     */
+    [[nodiscard]] std::int64_t count_used() const noexcept
+    {
+        auto count_used = std::int64_t{0};
+        for (auto numa_node_id = std::uint8_t(0U); numa_node_id < config::max_numa_nodes(); ++numa_node_id)
+        {
+            for (auto size_class = std::uint8_t(0U); size_class < config::count_size_classes(); ++size_class)
+            {
+                count_used += this->count_used(numa_node_id, size_class);
+            }
+        }
+
+        return count_used;
+    }
+
+    /**
+     * Forgets all objects; the caller has to guarantee that no object is in use.
+     */
+    void clear() noexcept;
+
+private:
+    using counters_t =
+        std::array<std::array<std::atomic_uint64_t, config::count_size_classes()>, config::max_numa_nodes()>;
+
+    std::atomic_bool _is_locked{false};
+
+    // Local free lists per NUMA region and size class.
+    std::array<std::array<List, config::count_size_classes()>, config::max_numa_nodes()> _lists{};
+
+    // Objects allocated and freed by the owning core per NUMA region and size class.
+    counters_t _count_allocated{};
+    counters_t _count_freed{};
+
+    // Objects freed by other cores.
+    alignas(64) std::array<std::array<std::atomic<FreeObject *>, config::count_size_classes()>,
+                           config::max_numa_nodes()> _remote_lists{};
+    counters_t _count_remote_freed{};
+
+    static void increment(std::atomic_uint64_t &counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Allocator for small objects, rounded up to power-of-two size classes.
+ * Every core allocates from its own magazine; freed objects return to the
+ * magazine of the core that carved them. Objects carry no header, their
+ * size class is derived from the span they are located in.
+ */
+class SizeClassAllocator
+{
+public:
+    SizeClassAllocator() noexcept;
+    SizeClassAllocator(const SizeClassAllocator &) = delete;
+    ~SizeClassAllocator() noexcept = default;
+
+    SizeClassAllocator &operator=(const SizeClassAllocator &) = delete;
+
+    /**
+     * @param alignment Requested alignment.
+     * @param size Requested size.
+     * @return Size class serving the request, config::count_size_classes() if there is none.
+     */
+    [[nodiscard]] static constexpr std::uint8_t size_class(const std::size_t alignment, const std::size_t size) noexcept
+    {
+        auto size_class = std::uint8_t(0U);
+        while (size_class < config::count_size_classes() &&
+               (SizeClassAllocator::object_size(size_class) < size ||
+                SizeClassAllocator::object_size(size_class) < alignment))
+        {
+            ++size_class;
+        }
+
+        return size_class;
+    }
+
+    /**
+     * @param size_class Size class.
+     * @return Size of the objects (and their alignment) of the size class.
+     */
+    [[nodiscard]] static constexpr std::size_t object_size(const std::uint8_t size_class) noexcept
+    {
+        return config::min_size_class() << size_class;
+    }
+
+    /**
+     * Allocates an object from the magazine of the calling core.
+     * @param numa_node_id NUMA region to allocate from.
+     * @param size_class Size class of the object.
+     * @return Allocated object, nullptr if the request can not be served from size classes.
+     */
+    void *allocate(std::uint8_t numa_node_id, std::uint8_t size_class) noexcept;
+
+    /**
+     * Frees an object.
+     * @param pointer Object to free.
+     * @return True, if the object was allocated from size classes.
+     */
+    bool free(void *pointer) noexcept;
+
+    /**
+     * @return True, if all allocated objects are freed.
+     */
+    [[nodiscard]] bool is_free() const noexcept;
+
+    /**
+     * @param numa_node_id NUMA region.
+     * @param size_class Size class.
+     * @return Memory held by the given size class on the given NUMA region.
+     */
+    [[nodiscard]] MemoryUsage usage(std::uint8_t numa_node_id, std::uint8_t size_class) const noexcept;
+
+    /**
+     * Returns the memory of spans, that stayed free for the given time, to the OS.
+     * Magazines locked by their owning core are skipped; trimming is allowed while
+     * allocating and freeing, but not concurrently to another trim.
+     *
+     * @param now Current time.
+     * @param unused_time Time a span has to stay free.
+     * @return Number of bytes returned to the OS.
+     */
+    std::size_t trim(std::chrono::steady_clock::time_point now, std::chrono::milliseconds unused_time) noexcept;
+
+    /**
+     * Returns all spans; the caller has to guarantee that no object is in use.
+     */
+    void release() noexcept;
+
+private:
+    // Virtual memory per NUMA region.
+    std::array<SizeClassRegion, config::max_numa_nodes()> _regions;
+
+    // Magazine of every core.
+    std::array<Magazine, tasking::config::max_cores()> _magazines;
+
+    /**
+     * Hands out the next span for a list, preferring spans trimmed before; called by the owner while locked.
+     * @param list List the span is carved for.
+     * @param numa_node_id NUMA region of the list.
+     * @param core_id Core owning the list.
+     * @param size_class Size class of the list.
+     * @return Start of the span, zero if no span is available.
+     */
+    std::uintptr_t next_span(Magazine::List &list, std::uint8_t numa_node_id, std::uint16_t core_id,
+                             std::uint8_t size_class) noexcept;
+
+    /**
+     * Trims the free spans of a single list; called while the magazine is locked.
+     * @param magazine Magazine holding the list.
+     * @param numa_node_id NUMA region of the list.
+     * @param size_class Size class of the list.
+     * @param now Current time.
+     * @param unused_time Time a span has to stay free.
+     * @return Number of bytes returned to the OS.
+     */
+    std::size_t trim(Magazine &magazine, std::uint8_t numa_node_id, std::uint8_t size_class,
+                     std::chrono::steady_clock::time_point now, std::chrono::milliseconds unused_time) noexcept;
+};
+} // namespace mx::memory::dynamic
\ No newline at end of file
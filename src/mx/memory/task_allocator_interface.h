@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory_usage.h"
 #include <cstdint>
 #include <cstdlib>
 
@@ -27,6 +28,18 @@ public:
      * @param address Address to free.
      */
     virtual void free(std::uint16_t core_id, void *address) noexcept = 0;
+
+    /**
+     * @param numa_node_id NUMA node.
+     * @return Memory held by the allocator on the given NUMA node.
+     */
+    [[nodiscard]] virtual MemoryUsage usage(std::uint8_t numa_node_id) const noexcept = 0;
+
+    /**
+     * @param numa_node_id NUMA node.
+     * @return Number of objects of the given NUMA node, freed by cores of other nodes.
+     */
+    [[nodiscard]] virtual std::uint64_t count_cross_node_frees(std::uint8_t numa_node_id) const noexcept = 0;
 };
 
 /**
@@ -48,5 +61,18 @@ public:
      * @param address Memory to free.
      */
     void free(const std::uint16_t /*core_id*/, void *address) noexcept override { std::free(address); }
+
+    /**
+     * @return Nothing, memory of the systems allocator is not accounted.
+     */
+    [[nodiscard]] MemoryUsage usage(const std::uint8_t /*numa_node_id*/) const noexcept override { return {}; }
+
+    /**
+     * @return Nothing, the systems allocator is not NUMA aware.
+     */
+    [[nodiscard]] std::uint64_t count_cross_node_frees(const std::uint8_t /*numa_node_id*/) const noexcept override
+    {
+        return 0U;
+    }
 };
 } // namespace mx::memory
\ No newline at end of file
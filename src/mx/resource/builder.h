@@ -35,7 +35,8 @@ public:
      * @param size Size of the data object.
      * @param hint  Hint for scheduling and synchronization.
      * @param arguments Arguments to the constructor.
-     * @return Tagged pointer holding the synchronization, assigned channel and pointer.
+     * @return Tagged pointer holding the synchronization, assigned channel and pointer;
+     *         nullptr, if the memory limit of the NUMA region is reached.
      */
     template <typename T, typename... Args>
     ptr build(const std::size_t size, resource::hint &&hint, Args &&... arguments) noexcept
@@ -56,8 +57,13 @@ public:
         const auto [channel_id, numa_node_id] = schedule(hint);
         const auto resource_information = information{channel_id, synchronization_method};
 
-        return ptr{new (_allocator.allocate(numa_node_id, 64U, size)) T(std::forward<Args>(arguments)...),
-                   resource_information};
+        auto *memory = _allocator.allocate(numa_node_id, 64U, size);
+        if (memory == nullptr)
+        {
+            return ptr{};
+        }
+
+        return ptr{new (memory) T(std::forward<Args>(arguments)...), resource_information};
     }
 
     /**
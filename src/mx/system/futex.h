@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mx::system {
+/**
+ * Encapsulates the futex system call to block and wake up threads on a 32bit word.
+ */
+class futex
+{
+public:
+    /**
+     * Blocks the calling thread as long as the word holds the expected value
+     * and no other thread wakes it up. May return spuriously.
+     *
+     * @param word Word to wait on.
+     * @param expected Value the word is expected to hold.
+     */
+    static void wait(std::atomic_uint32_t &word, const std::uint32_t expected) noexcept
+    {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr,
+                0);
+    }
+
+    /**
+     * Wakes up one thread blocked on the given word.
+     *
+     * @param word Word the thread is waiting on.
+     */
+    static void wake_one(std::atomic_uint32_t &word) noexcept
+    {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+};
+} // namespace mx::system
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace mx::system {
+/**
+ * Encapsulates access to the time stamp counter of the cpu.
+ * Timestamps are cheap to read (a few cycles, no system call) and can be
+ * converted to nanoseconds using the calibrated frequency of the counter;
+ * the counter is expected to be invariant, i.e., to tick at a constant
+ * rate and to be synchronized between cores.
+ */
+class tsc
+{
+public:
+    /**
+     * Reads the time stamp counter. The read is not serialized,
+     * the cpu may reorder it with surrounding instructions.
+     *
+     * @return Current value of the time stamp counter.
+     */
+    static std::uint64_t read() noexcept
+    {
+#if defined(__x86_64__) || defined(__amd64__)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return std::uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /**
+     * Reads the time stamp counter after all previous instructions
+     * are executed, e.g., to take the end of a measured range.
+     *
+     * @return Current value of the time stamp counter.
+     */
+    static std::uint64_t read_ordered() noexcept
+    {
+#if defined(__x86_64__) || defined(__amd64__)
+        std::uint32_t aux;
+        return __builtin_ia32_rdtscp(&aux);
+#elif defined(__aarch64__)
+        std::uint64_t value;
+        asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return tsc::read();
+#endif
+    }
+
+    /**
+     * The frequency is calibrated against the steady clock at the
+     * first call (taking about 10ms); later calls are free.
+     *
+     * @return Ticks of the time stamp counter per nanosecond.
+     */
+    static double ticks_per_nanosecond() noexcept
+    {
+        static const auto ticks_per_nanosecond = tsc::calibrate();
+        return ticks_per_nanosecond;
+    }
+
+    /**
+     * Converts a number of ticks (e.g., the difference of two timestamps) into nanoseconds.
+     *
+     * @param ticks Ticks of the time stamp counter.
+     * @return Nanoseconds.
+     */
+    static std::uint64_t to_nanoseconds(const std::uint64_t ticks) noexcept
+    {
+        return std::uint64_t(double(ticks) / tsc::ticks_per_nanosecond());
+    }
+
+private:
+    static double calibrate() noexcept
+    {
+#if defined(__aarch64__)
+        std::uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return double(frequency) / 1e9;
+#elif defined(__x86_64__) || defined(__amd64__)
+        const auto clock_start = std::chrono::steady_clock::now();
+        const auto tsc_start = tsc::read_ordered();
+
+        auto clock_end = clock_start;
+        do
+        {
+            clock_end = std::chrono::steady_clock::now();
+        } while (clock_end - clock_start < std::chrono::milliseconds(10));
+        const auto tsc_end = tsc::read_ordered();
+
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_start).count();
+        return double(tsc_end - tsc_start) / double(nanoseconds);
+#else
+        // Fallback reads the steady clock.
+        return double(std::chrono::steady_clock::period::den) / double(std::chrono::steady_clock::period::num) / 1e9;
+#endif
+    }
+};
+} // namespace mx::system
\ No newline at end of file
@@ -2,13 +2,20 @@
 
 #include "channel_occupancy.h"
 #include "load.h"
+#include "profiling/metrics.h"
 #include "task.h"
 #include "task_buffer.h"
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <mx/memory/config.h>
+#include <mx/synchronization/spinlock.h>
+#include <mx/synchronization/synchronization.h>
 #include <mx/system/cache.h>
+#include <mx/system/futex.h>
+#include <mx/system/tsc.h>
+#include <mx/util/maybe_atomic.h>
 #include <mx/util/mpsc_queue.h>
 #include <mx/util/queue.h>
 
@@ -32,9 +39,11 @@ namespace mx::tasking {
 class Channel
 {
 public:
-    constexpr Channel(const std::uint16_t id, const std::uint8_t numa_node_id,
-                      const std::uint8_t prefetch_distance) noexcept
-        : _remote_queues({}), _local_queues({}), _task_buffer(prefetch_distance), _id(id), _numa_node_id(numa_node_id)
+    constexpr Channel(const std::uint16_t id, const std::uint8_t numa_node_id, const std::uint8_t prefetch_distance,
+                      const std::uint16_t priority_aging_fills = config::priority_aging_fills(),
+                      const bool is_parking_enabled = config::worker_parking()) noexcept
+        : _remote_queues({}), _local_queues({}), _priority_aging_fills(priority_aging_fills),
+          _task_buffer(prefetch_distance), _id(id), _numa_node_id(numa_node_id), _is_parking_enabled(is_parking_enabled)
     {
     }
     ~Channel() noexcept = default;
@@ -59,6 +68,94 @@ public:
     void push_back_remote(TaskInterface *task, const std::uint8_t numa_node_id) noexcept
     {
         _remote_queues[task->priority()][numa_node_id].push_back(task);
+        _metrics.enqueued_remote(1U);
+        if (_is_parking_enabled)
+        {
+            this->wake_up_parked();
+        }
+    }
+
+    /**
+     * Schedules a list of linked tasks to the thread-safe queue with regard to
+     * the NUMA region of the producer. All tasks need the same priority.
+     * @param begin First task of the list.
+     * @param end Last task of the list.
+     * @param count Number of tasks in the list.
+     * @param numa_node_id NUMA region of the producer.
+     */
+    void push_back_remote(TaskInterface *begin, TaskInterface *end, const std::uint32_t count,
+                          const std::uint8_t numa_node_id) noexcept
+    {
+        _remote_queues[begin->priority()][numa_node_id].push_back(begin, end);
+        _metrics.enqueued_remote(count);
+        if (_is_parking_enabled)
+        {
+            this->wake_up_parked();
+        }
+    }
+
+    /**
+     * Parks the calling (owning) worker until a task is scheduled to
+     * a remote queue or wake_up() is called. The worker will not park
+     * when tasks are already available or the runtime is stopped.
+     * @param is_running Running flag of the runtime.
+     */
+    void park(const util::maybe_atomic<bool> &is_running) noexcept
+    {
+        _parking_word.store(Parked, std::memory_order_seq_cst);
+
+        // Producers push tasks before they look for a parked worker, we announce
+        // parking before looking for tasks; a task can not be missed in between.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (is_running && this->has_remote_tasks() == false)
+        {
+            system::futex::wait(_parking_word, Parked);
+        }
+
+        _parking_word.store(Running, std::memory_order_relaxed);
+    }
+
+    /**
+     * Wakes up the worker when it is parked.
+     */
+    void wake_up() noexcept
+    {
+        if (_parking_word.load(std::memory_order_relaxed) == Parked &&
+            _parking_word.exchange(Running, std::memory_order_seq_cst) == Parked)
+        {
+            system::futex::wake_one(_parking_word);
+        }
+    }
+
+    /**
+     * @return True, when the owning worker is parked; may be read by any thread.
+     */
+    [[nodiscard]] bool is_parked() const noexcept { return _parking_word.load(std::memory_order_relaxed) == Parked; }
+
+    /**
+     * Checks whether the oldest task of any remote queue may be stolen by a channel
+     * of the same NUMA region. Returns false while thieves consume the remote queues.
+     * @return True, when the remote queues hold a task other channels may steal.
+     */
+    [[nodiscard]] bool has_stealable_tasks() noexcept
+    {
+        if (_remote_queues_latch.try_lock() == false)
+        {
+            return false;
+        }
+
+        auto has_stealable_tasks = false;
+        for (const auto &queues : _remote_queues)
+        {
+            for (const auto &queue : queues)
+            {
+                const auto *task = queue.front();
+                has_stealable_tasks |= task != nullptr && Channel::is_stealable(task, _numa_node_id);
+            }
+        }
+
+        _remote_queues_latch.unlock();
+        return has_stealable_tasks;
     }
 
     /**
@@ -66,7 +163,11 @@ public:
      * the channel owner should spawn tasks this way.
      * @param task Task to be scheduled.
      */
-    void push_back_local(TaskInterface *task) noexcept { _local_queues[task->priority()].push_back(task); }
+    void push_back_local(TaskInterface *task) noexcept
+    {
+        _local_queues[task->priority()].push_back(task);
+        _metrics.enqueued_local();
+    }
 
     /**
      * Fill the task buffer with tasks from the backend queues.
@@ -74,15 +175,45 @@ public:
      */
     std::uint16_t fill() noexcept
     {
+        // The buffer may be full after filling, when its size is ambiguous;
+        // we track the size returned by every fill.
+        auto size = _task_buffer.size();
+
+        // Lower priorities that missed a deadline or were passed over
+        // too often are served first, avoiding their starvation.
+        const auto now =
+            config::task_deadlines() ? TaskInterface::deadline_ticks(system::tsc::read()) : std::uint16_t(0U);
+        size = this->fill_aged<priority::low>(size, now);
+        size = this->fill_aged<priority::normal>(size, now);
+
+        // Fill with high prioritized.
+        size = fill<priority::high>(_task_buffer.max_size() - size);
+
         // Fill with normal prioritized.
-        auto size = fill<priority::normal>(_task_buffer.available_slots());
+        if (size < _task_buffer.max_size())
+        {
+            size = fill<priority::normal>(_task_buffer.max_size() - size);
+            _passed_over_fills[priority::normal] = 0U;
+        }
+        else
+        {
+            ++_passed_over_fills[priority::normal];
+        }
 
         // Fill with low prioritized.
-        if (this->_task_buffer.empty())
+        if (size == 0U)
         {
             size = fill<priority::low>(config::task_buffer_size());
+            _passed_over_fills[priority::low] = 0U;
+        }
+        else
+        {
+            ++_passed_over_fills[priority::low];
         }
 
+        // Track whether the channel had work to do.
+        _load += size > 0U;
+
         return size;
     }
 
@@ -94,6 +225,113 @@ public:
      */
     template <priority P> std::uint16_t fill() noexcept { return fill<P>(_task_buffer.available_slots()); }
 
+    /**
+     * Checks the deadlines of the oldest tasks with the given priority;
+     * only the owning worker thread reads the local queue.
+     *
+     * @tparam P Priority.
+     * @param now Current time in deadline ticks.
+     * @return True, when the oldest task of any queue with the given priority missed its deadline.
+     */
+    template <priority P> bool is_deadline_missed(const std::uint16_t now) noexcept
+    {
+        auto *local_task = _local_queues[P].begin();
+        if (local_task != nullptr && local_task->is_deadline_missed(now))
+        {
+            return true;
+        }
+
+        // Thieves may consume the remote queues.
+        if constexpr (config::work_stealing())
+        {
+            _remote_queues_latch.lock();
+        }
+
+        auto is_missed = false;
+        for (const auto &queue : _remote_queues[P])
+        {
+            const auto *remote_task = queue.front();
+            if (remote_task != nullptr && remote_task->is_deadline_missed(now))
+            {
+                is_missed = true;
+                break;
+            }
+        }
+
+        if constexpr (config::work_stealing())
+        {
+            _remote_queues_latch.unlock();
+        }
+
+        return is_missed;
+    }
+
+    /**
+     * Fills the task buffer with tasks stolen from the remote queues of another
+     * channel. Only tasks that are not pinned to the victim channel will be stolen;
+     * NUMA-local remote queues of the victim are preferred.
+     * @param victim Channel to steal tasks from.
+     * @return Size of the task buffer after stealing.
+     */
+    std::uint16_t steal(Channel &victim) noexcept
+    {
+        // The victim (or another thief) is consuming the remote queues; try another victim.
+        if (victim._remote_queues_latch.try_lock() == false)
+        {
+            return _task_buffer.size();
+        }
+
+        // Leave at least half of the (visible) work to the victim and other thieves.
+        const auto limit = std::uint16_t(_task_buffer.available_slots() / 2U);
+        auto stolen = std::uint16_t{0U};
+        for (const auto priority_ : {priority::high, priority::normal, priority::low})
+        {
+            for (auto i = 0U; i < victim._remote_queues[priority_].max_size() && stolen < limit; ++i)
+            {
+                const auto numa_node_id = (_numa_node_id + i) & (victim._remote_queues[priority_].max_size() - 1U);
+                auto queue = StealableQueue{victim._remote_queues[priority_][numa_node_id], _numa_node_id,
+                                            std::uint16_t(limit - stolen)};
+                stolen += _task_buffer.fill(queue, _task_buffer.available_slots());
+            }
+        }
+
+        victim._remote_queues_latch.unlock();
+
+        if (stolen > 0U)
+        {
+            victim._metrics.stolen_from(stolen);
+            _metrics.stolen(stolen);
+        }
+
+        return _task_buffer.size();
+    }
+
+    /**
+     * Checks whether a task may be executed by a channel other than the
+     * one it was scheduled to.
+     * @param task Task to check.
+     * @param numa_node_id NUMA region of the stealing channel.
+     * @return True, when the task is not pinned to the channel.
+     */
+    [[nodiscard]] static bool is_stealable(const TaskInterface *task, const std::uint8_t numa_node_id) noexcept
+    {
+        if (task->has_resource_annotated())
+        {
+            const auto primitive = task->annotated_resource().synchronization_primitive();
+            return primitive == synchronization::primitive::None ||
+                   (task->is_readonly() && synchronization::is_optimistic(primitive));
+        }
+
+        // Tasks with annotated NUMA region may only move within that region.
+        if (task->has_node_annotated())
+        {
+            return task->annotated_node() == numa_node_id;
+        }
+
+        // Tasks with annotated channel are pinned by the developer.
+        return task->has_channel_annotated() == false;
+    }
+
     /**
      * @return Number of tasks available in the buffer and ready for execution.
      */
@@ -104,6 +342,26 @@ public:
      */
     [[nodiscard]] bool empty() const noexcept { return _task_buffer.empty(); }
 
+    /**
+     * Updates the distance for prefetching tasks and resources of this channel.
+     * @param prefetch_distance New prefetch distance.
+     */
+    void prefetch_distance(const std::uint8_t prefetch_distance) noexcept
+    {
+        _task_buffer.prefetch_distance(prefetch_distance);
+    }
+
+    /**
+     * @return Metrics of the channel; may be read by any thread.
+     */
+    [[nodiscard]] profiling::ChannelMetrics &metrics() noexcept { return _metrics; }
+    [[nodiscard]] const profiling::ChannelMetrics &metrics() const noexcept { return _metrics; }
+
+    /**
+     * @return Load of the channel, measured over the last fills; may be read by any thread.
+     */
+    [[nodiscard]] const Load &load() const noexcept { return _load; }
+
     /**
      * Adds usage prediction of a resource to this channel.
      * @param usage Predicted usage.
@@ -139,12 +397,24 @@ public:
     }
 
 private:
+    enum ParkingState : std::uint32_t
+    {
+        Running = 0U,
+        Parked = 1U
+    };
+
     // Backend queues for multiple produces in different NUMA regions and different priorities,
     alignas(64)
-        std::array<std::array<util::MPSCQueue<TaskInterface>, memory::config::max_numa_nodes()>, 2> _remote_queues{};
+        std::array<std::array<util::MPSCQueue<TaskInterface>, memory::config::max_numa_nodes()>, 3> _remote_queues{};
 
     // Backend queues for a single producer (owning worker thread) and different priorities.
-    alignas(64) std::array<util::Queue<TaskInterface>, 2> _local_queues{};
+    alignas(64) std::array<util::Queue<TaskInterface>, 3> _local_queues{};
+
+    // Number of fills every priority was passed over by higher priorities.
+    std::array<std::uint16_t, 3> _passed_over_fills{0U};
+
+    // Number of fills a priority may be passed over before it is served first, zero disables aging.
+    const std::uint16_t _priority_aging_fills;
 
     // Buffer for ready-to-execute tasks.
     alignas(64) TaskBuffer<config::task_buffer_size()> _task_buffer;
@@ -155,9 +425,122 @@ private:
     // NUMA id of the worker thread owning this channel.
     const std::uint8_t _numa_node_id;
 
+    // Pushing to remote queues wakes up the parked owner, see config::worker_parking().
+    const bool _is_parking_enabled;
+
     // Holder of resource predictions of this channel.
     alignas(64) ChannelOccupancy _occupancy{};
 
+    // Load of this channel, updated on every fill.
+    alignas(64) Load _load{};
+
+    // Latch for consuming the remote queues, only used when work stealing is enabled.
+    alignas(64) synchronization::Spinlock _remote_queues_latch;
+
+    // Word the owning worker parks on when no task is available.
+    alignas(64) std::atomic_uint32_t _parking_word{Running};
+
+    // Always-on metrics, polled by snapshots.
+    alignas(64) profiling::ChannelMetrics _metrics;
+
+    /**
+     * View on a remote queue that only yields tasks that can be stolen.
+     * Stealing stops at the first pinned task to keep the order of the queue.
+     */
+    class StealableQueue
+    {
+    public:
+        StealableQueue(util::MPSCQueue<TaskInterface> &queue, const std::uint8_t numa_node_id,
+                       const std::uint16_t limit) noexcept
+            : _queue(queue), _numa_node_id(numa_node_id), _limit(limit)
+        {
+        }
+        ~StealableQueue() noexcept = default;
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            const auto *task = _queue.front();
+            return _limit == 0U || task == nullptr || Channel::is_stealable(task, _numa_node_id) == false;
+        }
+
+        TaskInterface *pop_front() noexcept
+        {
+            if (empty())
+            {
+                return nullptr;
+            }
+
+            --_limit;
+            return _queue.pop_front();
+        }
+
+    private:
+        util::MPSCQueue<TaskInterface> &_queue;
+        const std::uint8_t _numa_node_id;
+        std::uint16_t _limit;
+    };
+
+    /**
+     * Wakes up the owning worker after a task was pushed to a remote queue,
+     * when the worker is parked.
+     */
+    void wake_up_parked() noexcept
+    {
+        // Pairs with the fence in park(): Either the parking worker
+        // sees the pushed task or we see the worker parked.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        this->wake_up();
+    }
+
+    /**
+     * @return True, when any remote queue holds a task.
+     */
+    [[nodiscard]] bool has_remote_tasks() const noexcept
+    {
+        for (const auto &queues : _remote_queues)
+        {
+            for (const auto &queue : queues)
+            {
+                if (queue.empty() == false)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Fills the task buffer with tasks of the given priority when the priority
+     * was passed over too many fills or its oldest task missed the deadline.
+     *
+     * @tparam P Priority.
+     * @param size Size of the task buffer.
+     * @param now Current time in deadline ticks.
+     * @return Size of the task buffer after filling.
+     */
+    template <priority P> std::uint16_t fill_aged(const std::uint16_t size, const std::uint16_t now) noexcept
+    {
+        auto is_aged = _priority_aging_fills > 0U && _passed_over_fills[P] >= _priority_aging_fills;
+        if constexpr (config::task_deadlines())
+        {
+            is_aged = is_aged || this->is_deadline_missed<P>(now);
+        }
+
+        // Aged tasks take at most half of the free slots; higher priorities are not starved in turn.
+        if (is_aged)
+        {
+            _passed_over_fills[P] = 0U;
+
+            // fill() reports the size as if all free slots were offered.
+            const auto count = std::uint16_t((_task_buffer.max_size() - size) / 2U);
+            return std::uint16_t(size + fill<P>(count) - (_task_buffer.max_size() - count));
+        }
+
+        return size;
+    }
+
     /**
      * Fills the task buffer with tasks scheduled with a given priority.
      *
@@ -172,12 +555,24 @@ private:
 
         if (available > 0U)
         {
+            // When work stealing is enabled, remote queues may be consumed by other
+            // channels; they have to be consumed exclusively.
+            if constexpr (config::work_stealing())
+            {
+                _remote_queues_latch.lock();
+            }
+
             // 2) Fill up from remote queues; start with the NUMA-local one.
             for (auto i = 0U; i < _remote_queues[P].max_size(); ++i)
             {
                 const auto numa_node_id = (_numa_node_id + i) & (_remote_queues[P].max_size() - 1U);
                 available -= _task_buffer.fill(_remote_queues[P][numa_node_id], available);
             }
+
+            if constexpr (config::work_stealing())
+            {
+                _remote_queues_latch.unlock();
+            }
         }
 
         return _task_buffer.max_size() - available;
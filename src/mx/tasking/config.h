@@ -14,26 +14,111 @@ public:
     // Maximal number of supported cores.
     static constexpr auto max_cores() { return 128U; }
 
+    // If enabled, every task carries the time stamp of its spawn and the
+    // task statistics record the time from spawn to execution per task
+    // type, otherwise only the execution time. Doubles the task size.
+    static constexpr auto task_queueing_statistics() { return false; }
+
     // Maximal size for a single task, will be used for task allocation.
-    static constexpr auto task_size() { return 64U; }
+    // Recording the queueing time needs eight more bytes per task.
+    static constexpr auto task_size() { return task_queueing_statistics() ? 128U : 64U; }
 
     // The task buffer will hold a set of tasks, fetched from
     // queues. This is the size of the buffer.
     static constexpr auto task_buffer_size() { return 64U; }
 
-    // If enabled, will record the number of execute tasks,
-    // scheduled tasks, reader and writer per core and more.
-    static constexpr auto task_statistics() { return false; }
+    // If enabled, the number of executed tasks, scheduled tasks, reader
+    // and writer per core and more can be recorded; recording is switched
+    // on and off at runtime (see diagnostics), off at start.
+    static constexpr auto task_statistics() { return true; }
+
+    // Number of task types, every channel records latencies for
+    // (as part of the task statistics); further types are ignored.
+    static constexpr auto task_statistics_types() { return 16U; }
+
+    // If enabled, every worker opens hardware performance counters
+    // (instructions, cycles, cache misses, stalls) and reads them via
+    // rdpmc around every task, as part of the task statistics per task
+    // type. Requires user space access to the counters by the kernel.
+    static constexpr auto task_perf_counters() { return false; }
+
+    // Number of named counters (built-in task statistics and counters
+    // registered by applications), every core holds; multiple of eight
+    // to pad the counters of a core to cache lines.
+    static constexpr auto task_statistics_counters() { return 32U; }
+
+    // If enabled, idle workers will steal tasks from remote queues
+    // of other channels (NUMA-local channels first). Tasks pinned to
+    // a channel by synchronization (ScheduleAll and writers of
+    // ScheduleWriter) or by a channel annotation will never be stolen.
+    static constexpr auto work_stealing() { return false; }
+
+    // If enabled, every channel tunes its prefetch distance at runtime,
+    // starting with the distance given at initialization. A distance
+    // of zero disables prefetching and adaption.
+    static constexpr auto adaptive_prefetch_distance() { return false; }
+
+    // If enabled, workers without tasks will back off by spinning
+    // for an exponentially growing time and finally park (sleep)
+    // until a task is scheduled to their channel. Otherwise,
+    // workers busy poll their channel. Parked workers do not steal;
+    // with work stealing, a worker whose buffer is full wakes up a
+    // parked worker when stealable tasks are left on its channel.
+    static constexpr auto worker_parking() { return false; }
+
+    // Number of exponential backoff rounds an idle worker
+    // spins (2^round pauses per round) before parking.
+    static constexpr auto worker_spin_rounds() { return 12U; }
+
+    // Number of fills a lower priority (normal, low) may be passed over
+    // by higher priorities before it is served first. This avoids the
+    // starvation of lower prioritized tasks. Zero disables aging, keeping
+    // the strict priority order; otherwise, every n-th fill also polls
+    // the queues of lower priorities, even when they are empty.
+    static constexpr auto priority_aging_fills() { return 0U; }
+
+    // If enabled, channels check the deadlines annotated to the oldest
+    // tasks of lower priorities and serve priorities that missed a
+    // deadline before higher ones.
+    static constexpr auto task_deadlines() { return false; }
+
+    // Deadlines are stored in ticks of 2^resolution cycles.
+    static constexpr auto task_deadline_resolution() { return 16U; }
+
+    // Size of the memory objects coroutine frames are allocated
+    // from; larger frames are allocated from the global heap.
+    static constexpr auto coroutine_frame_size() { return 256U; }
+
+    // Number of suspended coroutines a worker interleaves with
+    // other tasks before resuming the oldest one.
+    static constexpr auto coroutine_interleaving() { return 8U; }
+
+    // Number of failed validations after which an optimistic read falls
+    // back: Readers of resources synchronized by ScheduleWriter are
+    // rescheduled to the channel owning the resource (where readers need
+    // no validation), readers of OLFIT resources acquire the latch.
+    // Zero disables the fallback, readers retry until validation succeeds.
+    static constexpr auto optimistic_read_fallback() { return 0U; }
 
     // If enabled, memory will be reclaimed while using optimistic
     // synchronization by epoch-based reclamation. Otherwise, freeing
     // memory is unsafe.
     static constexpr auto memory_reclamation() { return memory_reclamation_scheme::UpdateEpochPeriodically; }
 
-    static constexpr auto tasking_array_length() { return 9000000; }
+    // Number of records the tasking profiler buffers per core until
+    // they are streamed to disk; records are dropped when it is full.
+    static constexpr auto tasking_profiler_buffer_size() { return 16384U; }
+
+    // Number of idle ranges logged per channel while profiling;
+    // further ranges are counted as dropped.
+    static constexpr auto idle_range_log_size() { return 65536U; }
 
+    // If enabled, the tasking profiler records enqueued tasks
+    // to derive the length of task queues.
     static constexpr auto use_task_queue_length() { return true; }
 
+    // If enabled, the tasking profiler can record executed tasks; recording
+    // is switched on and off at runtime (see diagnostics), on at start.
     static constexpr auto use_tasking_profiler() { return true; }
 };
 } // namespace mx::tasking
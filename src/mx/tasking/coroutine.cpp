@@ -0,0 +1,15 @@
+#include "coroutine.h"
+#include "runtime.h"
+#include <mx/system/topology.h>
+
+using namespace mx::tasking;
+
+void *Coroutine::promise_type::operator new(const std::size_t size)
+{
+    return runtime::new_coroutine_frame(system::topology::core_id(), size);
+}
+
+void Coroutine::promise_type::operator delete(void *frame, const std::size_t size) noexcept
+{
+    runtime::delete_coroutine_frame(system::topology::core_id(), frame, size);
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "config.h"
+#include "task.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mx/resource/resource.h>
+#include <mx/system/cache.h>
+#include <utility>
+
+namespace mx::tasking {
+/**
+ * Return type of coroutines that are executed as tasks, see CoroutineTask.
+ * Frames of the coroutines are allocated from a per-core allocator of the
+ * runtime; therefore, coroutines should be created and destroyed by tasks.
+ */
+class Coroutine
+{
+public:
+    class promise_type;
+    friend promise_type;
+
+    class promise_type
+    {
+    public:
+        constexpr promise_type() noexcept = default;
+        ~promise_type() noexcept = default;
+
+        Coroutine get_return_object() noexcept
+        {
+            return Coroutine{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        // The coroutine starts when the task is executed the first time.
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        // The frame is destroyed by the owning task.
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+
+        static void *operator new(std::size_t size);
+        static void operator delete(void *frame, std::size_t size) noexcept;
+    };
+
+    Coroutine(Coroutine &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    Coroutine(const Coroutine &) = delete;
+
+    ~Coroutine() noexcept
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+        }
+    }
+
+    Coroutine &operator=(const Coroutine &) = delete;
+    Coroutine &operator=(Coroutine &&other) noexcept
+    {
+        std::swap(_handle, other._handle);
+        return *this;
+    }
+
+    /**
+     * Runs the coroutine until its next suspension.
+     */
+    void resume() const { _handle.resume(); }
+
+    /**
+     * @return True, when the coroutine finished.
+     */
+    [[nodiscard]] bool is_done() const noexcept { return _handle.done(); }
+
+private:
+    explicit Coroutine(std::coroutine_handle<promise_type> handle) noexcept : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * Awaitable that prefetches a resource and suspends the coroutine.
+ * The worker executes other tasks while the resource is loaded into
+ * the cache and resumes the coroutine afterwards.
+ */
+class PrefetchAwaiter
+{
+public:
+    constexpr PrefetchAwaiter(void *address, const std::uint16_t size) noexcept : _address(address), _size(size) {}
+    ~PrefetchAwaiter() noexcept = default;
+
+    [[nodiscard]] bool await_ready() const noexcept { return _address == nullptr; }
+
+    void await_suspend(std::coroutine_handle<> /*handle*/) const noexcept
+    {
+        system::cache::prefetch_range<system::cache::L1, system::cache::read>(_address, _size);
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    void *_address;
+    const std::uint16_t _size;
+};
+
+/**
+ * The CoroutineTask executes a coroutine. Whenever the coroutine waits for a
+ * prefetched resource (co_await runtime::prefetch(...)), the task is suspended
+ * and the worker interleaves other tasks without re-scheduling it through the
+ * channel queues. The task is removed when the coroutine finished.
+ *
+ * Resources accessed by the coroutine are not synchronized by the runtime;
+ * the coroutine has to care for synchronization (e.g., by version checks).
+ * An annotated resource may only route the task, its synchronization primitive
+ * has to be none. Coroutines still suspended when the runtime stops are destroyed.
+ */
+class CoroutineTask final : public TaskInterface
+{
+public:
+    explicit CoroutineTask(Coroutine &&coroutine) noexcept : _coroutine(std::move(coroutine)) {}
+    ~CoroutineTask() override = default;
+
+    TaskResult execute(const std::uint16_t /*core_id*/, const std::uint16_t /*channel_id*/) override
+    {
+        _coroutine.resume();
+        return _coroutine.is_done() ? TaskResult::make_remove() : TaskResult::make_suspend();
+    }
+
+private:
+    Coroutine _coroutine;
+};
+} // namespace mx::tasking
\ No newline at end of file
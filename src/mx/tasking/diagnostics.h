@@ -0,0 +1,95 @@
+#pragma once
+#include "config.h"
+#include <atomic>
+#include <csignal>
+
+namespace mx::tasking {
+/**
+ * Switches diagnostics (task statistics and the tasking profiler) on and
+ * off while the runtime is running. Diagnostics compiled out by the config
+ * cost nothing; compiled in diagnostics cost one (well predicted) branch
+ * on a relaxed load when switched off.
+ */
+class diagnostics
+{
+public:
+    /**
+     * @return True, when task statistics are recorded.
+     */
+    [[nodiscard]] static bool is_statistics_enabled() noexcept
+    {
+        if constexpr (config::task_statistics())
+        {
+            return _is_statistics_enabled.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * @return True, when executed tasks are recorded by the tasking profiler.
+     */
+    [[nodiscard]] static bool is_profiling_enabled() noexcept
+    {
+        if constexpr (config::use_tasking_profiler())
+        {
+            return _is_profiling_enabled.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * @return True, when enqueued tasks are recorded by the tasking profiler.
+     */
+    [[nodiscard]] static bool is_task_queue_length_enabled() noexcept
+    {
+        return diagnostics::is_profiling_enabled() && config::use_task_queue_length() &&
+               _is_task_queue_length_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable_statistics(const bool is_enabled) noexcept
+    {
+        _is_statistics_enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    static void enable_profiling(const bool is_enabled) noexcept
+    {
+        _is_profiling_enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    static void enable_task_queue_length(const bool is_enabled) noexcept
+    {
+        _is_task_queue_length_enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * Installs a handler that switches statistics and profiling on or off
+     * (both to the opposite of the profiling state) whenever the process
+     * receives the given signal, e.g., "kill -USR1 <pid>" for SIGUSR1.
+     *
+     * @param signal Signal toggling the diagnostics.
+     */
+    static void toggle_on(const int signal) noexcept { std::signal(signal, &diagnostics::toggle); }
+
+private:
+    // Runtime switches; statistics have to be switched on, the profiler is on from the start.
+    inline static std::atomic_bool _is_statistics_enabled{false};
+    inline static std::atomic_bool _is_profiling_enabled{true};
+    inline static std::atomic_bool _is_task_queue_length_enabled{true};
+
+    static void toggle(int /*signal*/) noexcept
+    {
+        // Only lock-free atomics are accessed from the signal handler.
+        const auto is_enabled = !_is_profiling_enabled.load(std::memory_order_relaxed);
+        _is_profiling_enabled.store(is_enabled, std::memory_order_relaxed);
+        _is_statistics_enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    static_assert(std::atomic_bool::is_always_lock_free);
+};
+} // namespace mx::tasking
\ No newline at end of file
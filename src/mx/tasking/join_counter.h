@@ -0,0 +1,81 @@
+#pragma once
+#include "task.h"
+#include <atomic>
+#include <cstdint>
+
+namespace mx::tasking {
+/**
+ * The join counter expresses "run the continuation once all predecessors completed".
+ * Every predecessor task arrives at the counter when it is done; the last arriving
+ * predecessor gets the continuation handed and returns it as its successor, e.g.
+ *
+ *      return TaskResult::make_succeed_and_remove(join_counter.arrive());
+ *
+ * Predecessors that fork further predecessors (whose number is not known upfront)
+ * have to add() them before they arrive themselves. The counter has to outlive
+ * all predecessors; it does not own the continuation.
+ */
+class JoinCounter
+{
+public:
+    constexpr JoinCounter() noexcept = default;
+    JoinCounter(const std::uint32_t count_predecessors, TaskInterface *continuation) noexcept
+        : _pending(count_predecessors), _continuation(continuation)
+    {
+    }
+
+    ~JoinCounter() noexcept = default;
+
+    JoinCounter &operator=(const JoinCounter &) = delete;
+
+    /**
+     * Resets the counter to wait for the given predecessors and continuation.
+     * Must not be called while predecessors are in flight.
+     *
+     * @param count_predecessors Number of predecessors to wait for.
+     * @param continuation Task that becomes runnable after all predecessors arrived.
+     */
+    void reset(const std::uint32_t count_predecessors, TaskInterface *continuation) noexcept
+    {
+        _pending.store(count_predecessors, std::memory_order_relaxed);
+        _continuation = continuation;
+    }
+
+    /**
+     * Registers further predecessors. The caller has to be a predecessor
+     * that did not arrive, yet; otherwise the continuation may already run.
+     *
+     * @param count Number of additional predecessors.
+     */
+    void add(const std::uint32_t count = 1U) noexcept { _pending.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * Marks predecessors as completed.
+     *
+     * @param count Number of completed predecessors.
+     * @return The continuation, when the last predecessor arrived; nullptr otherwise.
+     */
+    [[nodiscard]] TaskInterface *arrive(const std::uint32_t count = 1U) noexcept
+    {
+        // Acquire and release make the work of all predecessors visible to the continuation.
+        if (_pending.fetch_sub(count, std::memory_order_acq_rel) == count)
+        {
+            return _continuation;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @return Number of predecessors that did not arrive, yet.
+     */
+    [[nodiscard]] std::uint32_t pending() const noexcept { return _pending.load(std::memory_order_relaxed); }
+
+private:
+    // Number of predecessors that did not arrive, yet.
+    std::atomic_uint32_t _pending{0U};
+
+    // Task that will be handed to the last arriving predecessor.
+    TaskInterface *_continuation{nullptr};
+};
+} // namespace mx::tasking
\ No newline at end of file
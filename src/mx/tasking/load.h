@@ -1,10 +1,12 @@
 #pragma once
-#include <bitset>
+#include <atomic>
 #include <cstdint>
 
 namespace mx::tasking {
 /**
  * Persists the channel load for the last 64 requests.
+ * The load is written by a single thread (the owning worker)
+ * but may be read by any thread.
  */
 class Load
 {
@@ -14,27 +16,31 @@ public:
 
     Load &operator+=(const bool hit) noexcept
     {
-        _hits <<= 1;
-        _hits.set(0, hit);
+        const auto hits = _hits.load(std::memory_order_relaxed);
+        _hits.store((hits << 1U) | static_cast<std::uint64_t>(hit), std::memory_order_relaxed);
         return *this;
     }
 
     Load &operator|=(const Load &other) noexcept
     {
-        _hits |= other._hits;
+        _hits.store(_hits.load(std::memory_order_relaxed) | other._hits.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
         return *this;
     }
 
     /**
      * @return Number of successful requests.
      */
-    [[nodiscard]] std::size_t count() const noexcept { return _hits.count(); }
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return static_cast<std::size_t>(__builtin_popcountll(_hits.load(std::memory_order_relaxed)));
+    }
 
-    bool operator<(const Load &other) const noexcept { return _hits.count() < other._hits.count(); }
-    bool operator<(const std::size_t other) const noexcept { return _hits.count() < other; }
+    bool operator<(const Load &other) const noexcept { return count() < other.count(); }
+    bool operator<(const std::size_t other) const noexcept { return count() < other; }
 
 private:
     // Bitvector of the last 64 requests.
-    std::bitset<64> _hits{0U};
+    std::atomic_uint64_t _hits{0U};
 };
 } // namespace mx::tasking
\ No newline at end of file
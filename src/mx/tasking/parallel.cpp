@@ -0,0 +1,30 @@
+#include "parallel.h"
+#include "runtime.h"
+
+using namespace mx::tasking;
+
+TaskResult ParallelChunkTask::execute(const std::uint16_t core_id, const std::uint16_t channel_id)
+{
+    // Split off the upper half until the chunk fits the grain; split
+    // halves are published where idle channels are able to steal them.
+    while (this->_end - this->_begin > this->_context.grain())
+    {
+        const auto middle = this->_begin + (this->_end - this->_begin) / 2U;
+        auto *split_task = runtime::new_task<ParallelChunkTask>(core_id, this->_context, middle, this->_end);
+        this->_context.join_counter().add();
+        runtime::spawn_stealable(*split_task, channel_id);
+        this->_end = middle;
+    }
+
+    this->_context.execute(this->_begin, this->_end, channel_id);
+
+    return TaskResult::make_succeed_and_remove(this->_context.join_counter().arrive());
+}
+
+TaskResult ParallelFinishTask::execute(const std::uint16_t /*core_id*/, const std::uint16_t /*channel_id*/)
+{
+    this->_context->finish();
+    delete this->_context;
+
+    return TaskResult::make_remove();
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+#include "config.h"
+#include "join_counter.h"
+#include "task.h"
+#include <array>
+#include <cstdint>
+#include <mx/util/aligned_t.h>
+#include <type_traits>
+#include <utility>
+
+namespace mx::tasking {
+/**
+ * Shared state of a parallel_for/parallel_reduce: the function applied
+ * to the chunks of the range, the grain and the join counter that runs
+ * the completion when all chunks are done.
+ */
+class ParallelContextInterface
+{
+public:
+    explicit ParallelContextInterface(const std::uint64_t grain) noexcept : _grain(grain > 0U ? grain : 1U) {}
+    virtual ~ParallelContextInterface() noexcept = default;
+
+    /**
+     * Applies the function to a chunk that will not be split further.
+     *
+     * @param begin First index of the chunk.
+     * @param end Index behind the last index of the chunk.
+     * @param channel_id Channel the chunk is executed on.
+     */
+    virtual void execute(std::uint64_t begin, std::uint64_t end, std::uint16_t channel_id) = 0;
+
+    /**
+     * Called once after all chunks are executed.
+     */
+    virtual void finish() = 0;
+
+    /**
+     * @return Maximal size of a chunk that is not split further.
+     */
+    [[nodiscard]] std::uint64_t grain() const noexcept { return _grain; }
+
+    /**
+     * @return Counter joining all chunks.
+     */
+    [[nodiscard]] JoinCounter &join_counter() noexcept { return _join_counter; }
+
+private:
+    // Every chunk arrives here, the last one runs the completion.
+    alignas(64) JoinCounter _join_counter;
+
+    // Chunks larger than the grain are split.
+    const std::uint64_t _grain;
+};
+
+/**
+ * Context of a parallel_for, calling the function for every index.
+ */
+template <typename F, typename C> class ParallelForContext final : public ParallelContextInterface
+{
+public:
+    ParallelForContext(const std::uint64_t grain, F &&function, C &&callback) noexcept
+        : ParallelContextInterface(grain), _function(std::forward<F>(function)), _callback(std::forward<C>(callback))
+    {
+    }
+
+    ~ParallelForContext() noexcept override = default;
+
+    void execute(const std::uint64_t begin, const std::uint64_t end, const std::uint16_t /*channel_id*/) override
+    {
+        for (auto index = begin; index < end; ++index)
+        {
+            _function(index);
+        }
+    }
+
+    void finish() override { _callback(); }
+
+private:
+    std::decay_t<F> _function;
+    std::decay_t<C> _callback;
+};
+
+/**
+ * Context of a parallel_reduce. Every channel combines the values of its
+ * chunks into a local partial result; the partial results are combined
+ * when all chunks are done.
+ */
+template <typename T, typename M, typename R, typename C>
+class ParallelReduceContext final : public ParallelContextInterface
+{
+public:
+    ParallelReduceContext(const std::uint64_t grain, const std::uint16_t count_channels, const T &identity, M &&map,
+                          R &&reduce, C &&callback) noexcept
+        : ParallelContextInterface(grain), _count_channels(count_channels), _identity(identity),
+          _map(std::forward<M>(map)), _reduce(std::forward<R>(reduce)), _callback(std::forward<C>(callback))
+    {
+        _partial_results.fill(util::aligned_t<T>{identity});
+    }
+
+    ~ParallelReduceContext() noexcept override = default;
+
+    void execute(const std::uint64_t begin, const std::uint64_t end, const std::uint16_t channel_id) override
+    {
+        auto result = _identity;
+        for (auto index = begin; index < end; ++index)
+        {
+            result = _reduce(std::move(result), _map(index));
+        }
+
+        // Only the worker of the channel writes the partial result of the channel.
+        auto &partial_result = _partial_results[channel_id].value();
+        partial_result = _reduce(std::move(partial_result), std::move(result));
+    }
+
+    void finish() override
+    {
+        auto result = _identity;
+        for (auto channel_id = 0U; channel_id < _count_channels; ++channel_id)
+        {
+            result = _reduce(std::move(result), std::move(_partial_results[channel_id].value()));
+        }
+
+        _callback(std::move(result));
+    }
+
+private:
+    const std::uint16_t _count_channels;
+    const T _identity;
+    std::decay_t<M> _map;
+    std::decay_t<R> _reduce;
+    std::decay_t<C> _callback;
+    std::array<util::aligned_t<T>, config::max_cores()> _partial_results;
+};
+
+/**
+ * Executes a chunk of a parallel_for/parallel_reduce. Chunks larger than
+ * the grain split off their upper half into a new task on the same channel
+ * (where idle channels can steal it) until the remaining chunk fits the grain.
+ */
+class ParallelChunkTask final : public TaskInterface
+{
+public:
+    constexpr ParallelChunkTask(ParallelContextInterface &context, const std::uint64_t begin,
+                                const std::uint64_t end) noexcept
+        : _context(context), _begin(begin), _end(end)
+    {
+    }
+
+    ~ParallelChunkTask() override = default;
+
+    TaskResult execute(std::uint16_t core_id, std::uint16_t channel_id) override;
+
+private:
+    ParallelContextInterface &_context;
+    std::uint64_t _begin;
+    std::uint64_t _end;
+};
+
+/**
+ * Continuation of all chunks: Runs the completion and frees the context.
+ */
+class ParallelFinishTask final : public TaskInterface
+{
+public:
+    constexpr explicit ParallelFinishTask(ParallelContextInterface *context) noexcept : _context(context) {}
+    ~ParallelFinishTask() override = default;
+
+    TaskResult execute(std::uint16_t core_id, std::uint16_t channel_id) override;
+
+private:
+    ParallelContextInterface *_context;
+};
+} // namespace mx::tasking
\ No newline at end of file
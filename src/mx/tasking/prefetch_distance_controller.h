@@ -0,0 +1,139 @@
+#pragma once
+
+#include "config.h"
+#include <algorithm>
+#include <cstdint>
+#include <mx/system/tsc.h>
+
+namespace mx::tasking {
+/**
+ * Tunes the prefetch distance of a single channel at runtime.
+ * The controller measures the cycles spent per executed task
+ * over epochs of tasks and moves the prefetch distance stepwise
+ * into the direction that reduced the cycles per task (hill climbing).
+ * Memory bound tasks will profit from prefetching earlier, compute
+ * bound tasks from prefetching less tasks in advance.
+ */
+class PrefetchDistanceController
+{
+public:
+    constexpr explicit PrefetchDistanceController(const std::uint16_t prefetch_distance) noexcept
+        : _prefetch_distance(prefetch_distance)
+    {
+    }
+    ~PrefetchDistanceController() noexcept = default;
+
+    /**
+     * @return The current prefetch distance.
+     */
+    [[nodiscard]] std::uint16_t prefetch_distance() const noexcept { return _prefetch_distance; }
+
+    /**
+     * Records an executed task.
+     * @return True, when the prefetch distance was modified.
+     */
+    bool executed() noexcept { return executed([] { return system::tsc::read(); }); }
+
+    /**
+     * Records an executed task.
+     * @param read_timestamp Callable returning the current time stamp; called at epoch boundaries, only.
+     * @return True, when the prefetch distance was modified.
+     */
+    template <typename F> bool executed(F &&read_timestamp) noexcept
+    {
+        // Prefetching is disabled and not adapted.
+        if (_prefetch_distance == 0U)
+        {
+            return false;
+        }
+
+        if (_epoch_start == 0U)
+        {
+            _epoch_start = read_timestamp();
+            return false;
+        }
+
+        if (++_epoch_tasks < epoch_size())
+        {
+            return false;
+        }
+
+        return adapt(read_timestamp());
+    }
+
+    /**
+     * @return Number of tasks per measured epoch.
+     */
+    static constexpr std::uint16_t epoch_size() { return 1024U; }
+
+    /**
+     * @return Smallest prefetch distance, the controller will choose.
+     */
+    static constexpr std::uint16_t min_prefetch_distance() { return 1U; }
+
+    /**
+     * @return Greatest prefetch distance, the controller will choose; the
+     *         task buffer has to hold more tasks than the prefetch distance.
+     */
+    static constexpr std::uint16_t max_prefetch_distance() { return config::task_buffer_size() / 2U; }
+
+    /**
+     * Discards the current epoch; called when the channel runs
+     * out of tasks, because idle time should not be measured.
+     */
+    void idle() noexcept
+    {
+        _epoch_start = 0U;
+        _epoch_tasks = 0U;
+    }
+
+private:
+    // Current prefetch distance.
+    std::uint16_t _prefetch_distance;
+
+    // Direction of the last modification.
+    std::int8_t _direction{1};
+
+    // Number of tasks executed in the current epoch.
+    std::uint16_t _epoch_tasks{0U};
+
+    // Time stamp at the begin of the current epoch.
+    std::uint64_t _epoch_start{0U};
+
+    // Cycles per task measured in the last epoch.
+    std::uint64_t _last_cycles_per_task{0U};
+
+    /**
+     * Finishes the current epoch and modifies the prefetch distance.
+     * @param now Time stamp at the end of the epoch.
+     * @return True, when the prefetch distance was modified.
+     */
+    bool adapt(const std::uint64_t now) noexcept
+    {
+        const auto cycles_per_task = (now - _epoch_start) / _epoch_tasks;
+        _epoch_start = now;
+        _epoch_tasks = 0U;
+
+        // The last step made things worse; turn around.
+        if (cycles_per_task > _last_cycles_per_task && _last_cycles_per_task > 0U)
+        {
+            _direction = -_direction;
+        }
+        _last_cycles_per_task = cycles_per_task;
+
+        const auto prefetch_distance = static_cast<std::uint16_t>(
+            std::clamp(std::int32_t(_prefetch_distance) + _direction, std::int32_t(min_prefetch_distance()),
+                       std::int32_t(max_prefetch_distance())));
+
+        // Reached a bound; try the other direction next time.
+        if (prefetch_distance == _prefetch_distance)
+        {
+            _direction = -_direction;
+            return false;
+        }
+
+        _prefetch_distance = prefetch_distance;
+        return true;
+    }
+};
+} // namespace mx::tasking
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <mx/tasking/config.h>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mx::tasking::profiling {
+/**
+ * Registry of named counters, e.g., executed tasks or splits of a tree.
+ * Counters are registered at startup; every core owns a cache line padded
+ * block holding all counters, which is only written by the thread running
+ * on that core. Threads not owning a core (e.g., spawning tasks from outside
+ * the runtime) use a shared block. Counters are read via relaxed loads by
+ * any thread.
+ */
+class CounterRegistry
+{
+public:
+    using counter_id_t = std::uint16_t;
+
+    explicit CounterRegistry(const std::uint16_t count_cores)
+        : _count_cores(count_cores), _blocks(new Block[count_cores + 1U])
+    {
+    }
+
+    CounterRegistry(const CounterRegistry &) = delete;
+    ~CounterRegistry() noexcept = default;
+
+    CounterRegistry &operator=(const CounterRegistry &) = delete;
+
+    /**
+     * Registers a counter. Registering a name twice returns the same counter.
+     * At most config::task_statistics_counters() counters can be registered,
+     * further registrations return the last counter.
+     *
+     * @param name Name of the counter.
+     * @return Id of the counter.
+     */
+    counter_id_t register_counter(std::string name)
+    {
+        std::lock_guard _{this->_register_latch};
+
+        const auto count_counters = this->_count_counters.load(std::memory_order_relaxed);
+        for (auto id = counter_id_t(0U); id < count_counters; ++id)
+        {
+            if (this->_names[id] == name)
+            {
+                return id;
+            }
+        }
+
+        // Without space left, the counter shares the last registered one.
+        assert(count_counters < this->_names.size() && "Too many counters registered.");
+        if (count_counters == this->_names.size())
+        {
+            return counter_id_t(count_counters - 1U);
+        }
+
+        this->_names[count_counters] = std::move(name);
+        this->_count_counters.store(counter_id_t(count_counters + 1U), std::memory_order_release);
+        return count_counters;
+    }
+
+    /**
+     * @param name Name of the counter.
+     * @return Id of the counter, if registered.
+     */
+    [[nodiscard]] std::optional<counter_id_t> find(const std::string_view name) const noexcept
+    {
+        for (auto id = counter_id_t(0U); id < this->count_counters(); ++id)
+        {
+            if (this->_names[id] == name)
+            {
+                return id;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @return Number of registered counters.
+     */
+    [[nodiscard]] counter_id_t count_counters() const noexcept
+    {
+        return this->_count_counters.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @param counter_id Id of the counter.
+     * @return Name of the counter.
+     */
+    [[nodiscard]] const std::string &name(const counter_id_t counter_id) const noexcept
+    {
+        return this->_names[counter_id];
+    }
+
+    /**
+     * Adds a value to the counter of the given core; only
+     * the thread owning the core is allowed to increment.
+     *
+     * @param core_id Core owning the block.
+     * @param counter_id Id of the counter.
+     * @param value Value to add.
+     */
+    void increment(const std::uint16_t core_id, const counter_id_t counter_id, const std::uint64_t value = 1U) noexcept
+    {
+        // Single writer: No atomic read-modify-write needed.
+        auto &counter = this->_blocks[core_id].counters[counter_id];
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds a value to the counter of the shared block; any thread is allowed to increment.
+     *
+     * @param counter_id Id of the counter.
+     * @param value Value to add.
+     */
+    void increment_shared(const counter_id_t counter_id, const std::uint64_t value = 1U) noexcept
+    {
+        this->_blocks[this->_count_cores].counters[counter_id].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @param counter_id Id of the counter.
+     * @param core_id Core owning the block.
+     * @return Value of the counter for the given core.
+     */
+    [[nodiscard]] std::uint64_t get(const counter_id_t counter_id, const std::uint16_t core_id) const noexcept
+    {
+        return this->_blocks[core_id].counters[counter_id].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @param counter_id Id of the counter.
+     * @return Value of the counter, aggregated over all cores and the shared block.
+     */
+    [[nodiscard]] std::uint64_t get(const counter_id_t counter_id) const noexcept
+    {
+        auto sum = std::uint64_t{0U};
+        for (auto core_id = 0U; core_id <= this->_count_cores; ++core_id)
+        {
+            sum += this->get(counter_id, core_id);
+        }
+
+        return sum;
+    }
+
+    /**
+     * Resets all counters to zero; registered counters remain.
+     */
+    void clear() noexcept
+    {
+        for (auto core_id = 0U; core_id <= this->_count_cores; ++core_id)
+        {
+            for (auto &counter : this->_blocks[core_id].counters)
+            {
+                counter.store(0U, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    /**
+     * All counters of a single core, padded to cache lines.
+     */
+    struct alignas(64) Block
+    {
+        std::array<std::atomic_uint64_t, config::task_statistics_counters()> counters{};
+    };
+    static_assert(sizeof(Block) % 64U == 0U);
+
+    // Number of cores owning a block; the block behind is shared.
+    const std::uint16_t _count_cores;
+
+    // Counters of all cores and the shared block.
+    std::unique_ptr<Block[]> _blocks;
+
+    // Names of the registered counters.
+    std::array<std::string, config::task_statistics_counters()> _names;
+    std::atomic<counter_id_t> _count_counters{0U};
+    std::mutex _register_latch;
+};
+} // namespace mx::tasking::profiling
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "idle_profiler.h"
+#include <fstream>
+#include <json.hpp>
+#include <mx/tasking/config.h>
+
+using namespace mx::tasking::profiling;
+
+void Profiler::profile(const std::string &profiling_output_file, const std::uint16_t count_channels)
+{
+    // Workers may still write the logs, which are therefore never freed.
+    for (auto &idle_range_log : this->_idle_range_logs)
+    {
+        idle_range_log->reset();
+    }
+
+    for (auto channel_id = this->_idle_range_logs.size(); channel_id < count_channels; ++channel_id)
+    {
+        this->_idle_range_logs.emplace_back(std::make_unique<IdleRangeLog>(config::idle_range_log_size()));
+    }
+
+    this->_profiling_output_file.emplace(profiling_output_file);
+    // Calibrate the time stamp counter now, not when the results are written.
+    system::tsc::ticks_per_nanosecond();
+    this->_start = system::tsc::read();
+}
+
+void Profiler::stop()
+{
+    const auto end = system::tsc::read();
+    const auto end_relative_nanoseconds = system::tsc::to_nanoseconds(end - this->_start);
+    if (this->_profiling_output_file.has_value())
+    {
+        auto output = nlohmann::json{};
+        for (auto channel_id = 0U; channel_id < this->_idle_range_logs.size(); ++channel_id)
+        {
+            const auto &idle_range_log = *this->_idle_range_logs[channel_id];
+            const auto size = idle_range_log.size();
+            if (size > 0U)
+            {
+                nlohmann::json channel_output;
+                channel_output["channel"] = channel_id;
+                nlohmann::json ranges{};
+                for (auto i = 0U; i < size; ++i)
+                {
+                    // Workers may log a range that ended before the log was reset.
+                    if (idle_range_log[i].ends_before(this->_start))
+                    {
+                        continue;
+                    }
+
+                    const auto normalized = idle_range_log[i].normalize(this->_start);
+                    auto normalized_json = nlohmann::json{};
+                    normalized_json["s"] = std::get<0>(normalized);
+                    normalized_json["e"] = std::get<1>(normalized);
+                    ranges.push_back(std::move(normalized_json));
+                }
+
+                channel_output["ranges"] = std::move(ranges);
+                channel_output["dropped"] = idle_range_log.dropped();
+                output.push_back(std::move(channel_output));
+            }
+        }
+
+        nlohmann::json end_output;
+        end_output["end"] = end_relative_nanoseconds;
+        output.push_back(std::move(end_output));
+
+        std::ofstream out_file{this->_profiling_output_file.value()};
+        out_file << output.dump() << std::endl;
+    }
+
+    this->_profiling_output_file = std::nullopt;
+}
\ No newline at end of file
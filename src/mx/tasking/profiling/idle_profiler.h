@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mx/system/tsc.h>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mx::tasking::profiling {
+/**
+ * Time range (from -- to) for idled time of a single channel.
+ * Start and end are timestamps of the time stamp counter;
+ * they are converted into nanoseconds when the results are written.
+ */
+class IdleRange
+{
+public:
+    constexpr IdleRange() noexcept = default;
+    constexpr IdleRange(const std::uint64_t start, const std::uint64_t end) noexcept : _start(start), _end(end) {}
+    ~IdleRange() noexcept = default;
+
+    IdleRange &operator=(const IdleRange &) noexcept = default;
+
+    /**
+     * @return Number of ticks idled.
+     */
+    [[nodiscard]] std::uint64_t ticks() const noexcept { return _end - _start; }
+
+    /**
+     * @return Number of nanoseconds idled.
+     */
+    [[nodiscard]] std::uint64_t nanoseconds() const noexcept { return system::tsc::to_nanoseconds(_end - _start); }
+
+    /**
+     * @param timestamp Timestamp.
+     * @return True, if idling ended before the given timestamp.
+     */
+    [[nodiscard]] bool ends_before(const std::uint64_t timestamp) const noexcept { return _end <= timestamp; }
+
+    /**
+     * Normalizes this range with respect to a given point in time.
+     * Ranges started before that point are cut to start at that point.
+     *
+     * @param global_start Timestamp to normalize.
+     * @return Pair of (start, stop) in nanoseconds normalized to the given timestamp.
+     */
+    [[nodiscard]] std::pair<std::uint64_t, std::uint64_t> normalize(const std::uint64_t global_start) const noexcept
+    {
+        return {
+            system::tsc::to_nanoseconds(std::max(_start, global_start) - global_start),
+            system::tsc::to_nanoseconds(_end - global_start),
+        };
+    }
+
+private:
+    // Start of idling.
+    std::uint64_t _start{0U};
+
+    // End of idling.
+    std::uint64_t _end{0U};
+};
+
+/**
+ * Fixed-size log of the idle ranges of a single channel. Only the worker
+ * of the channel writes; ranges are dropped when the log is full. Since
+ * the log may be reset while the worker is running, the reset is only
+ * requested and carried out by the worker at the next push.
+ */
+class IdleRangeLog
+{
+public:
+    explicit IdleRangeLog(const std::uint32_t capacity) : _ranges(capacity) {}
+    ~IdleRangeLog() noexcept = default;
+
+    /**
+     * Logs an idle range; called by the owning worker, only.
+     * @param start Timestamp the worker found no task.
+     * @param end Timestamp the worker found tasks again.
+     */
+    void push(const std::uint64_t start, const std::uint64_t end) noexcept
+    {
+        if (this->_is_reset_requested.load(std::memory_order_relaxed))
+        {
+            this->_size.store(0U, std::memory_order_relaxed);
+            this->_dropped.store(0U, std::memory_order_relaxed);
+            this->_is_reset_requested.store(false, std::memory_order_release);
+        }
+
+        const auto size = this->_size.load(std::memory_order_relaxed);
+        if (size < this->_ranges.size())
+        {
+            this->_ranges[size] = IdleRange{start, end};
+            this->_size.store(size + 1U, std::memory_order_release);
+        }
+        else
+        {
+            this->_dropped.store(this->_dropped.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Requests to discard all logged ranges; any thread is allowed to reset.
+     */
+    void reset() noexcept { this->_is_reset_requested.store(true, std::memory_order_release); }
+
+    /**
+     * @return Number of logged ranges; ranges up to this number can be read by any thread.
+     */
+    [[nodiscard]] std::uint64_t size() const noexcept
+    {
+        // The worker clears the request after discarding the ranges.
+        if (this->_is_reset_requested.load(std::memory_order_acquire))
+        {
+            return 0U;
+        }
+
+        return this->_size.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return Number of ranges dropped, because the log was full.
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept
+    {
+        return this->_is_reset_requested.load(std::memory_order_acquire)
+                   ? 0U
+                   : this->_dropped.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] const IdleRange &operator[](const std::size_t index) const noexcept { return this->_ranges[index]; }
+
+private:
+    std::vector<IdleRange> _ranges;
+    std::atomic_uint64_t _size{0U};
+    std::atomic_uint64_t _dropped{0U};
+    std::atomic_bool _is_reset_requested{false};
+};
+
+/**
+ * Collects the idle ranges, measured by the workers between an empty
+ * and the next non-empty fill of their task buffer, and writes them
+ * to a given file.
+ */
+class Profiler
+{
+public:
+    Profiler() noexcept = default;
+    ~Profiler() noexcept = default;
+
+    /**
+     * Enable profiling and set the result file. Logs are allocated
+     * at the first call and reset at later calls.
+     * @param profiling_output_file File, where results should be written to.
+     * @param count_channels Number of channels to log idle ranges for.
+     */
+    void profile(const std::string &profiling_output_file, std::uint16_t count_channels);
+
+    /**
+     * @param channel_id Channel.
+     * @return Log for the idle ranges of the given channel.
+     */
+    [[nodiscard]] IdleRangeLog *idle_range_log(const std::uint16_t channel_id) noexcept
+    {
+        return this->_idle_range_logs[channel_id].get();
+    }
+
+    /**
+     * Normalizes all time ranges and writes them to the specified
+     * file.
+     */
+    void stop();
+
+private:
+    // File to write the output.
+    std::optional<std::string> _profiling_output_file{std::nullopt};
+
+    // Timestamp of the runtime start.
+    std::uint64_t _start{0U};
+
+    // Idle ranges of every channel.
+    std::vector<std::unique_ptr<IdleRangeLog>> _idle_range_logs;
+};
+
+} // namespace mx::tasking::profiling
\ No newline at end of file
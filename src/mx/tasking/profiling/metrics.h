@@ -0,0 +1,314 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mx/system/tsc.h>
+
+namespace mx::tasking::profiling {
+/**
+ * Histogram of latencies (in cycles) with four buckets per power of two,
+ * i.e., values are recorded with a relative error of at most 25%.
+ * The histogram is written by a single thread but may be read by any thread.
+ */
+class LatencyHistogram
+{
+public:
+    constexpr LatencyHistogram() noexcept = default;
+    ~LatencyHistogram() noexcept = default;
+
+    /**
+     * Records a latency. Only one thread may record latencies.
+     * @param cycles Latency in cycles.
+     */
+    void record(const std::uint64_t cycles) noexcept
+    {
+        auto &bucket = _buckets[LatencyHistogram::bucket_index(cycles)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return Number of recorded latencies.
+     */
+    [[nodiscard]] std::uint64_t count() const noexcept
+    {
+        auto count = std::uint64_t{0U};
+        for (const auto &bucket : _buckets)
+        {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+
+        return count;
+    }
+
+    /**
+     * Calculates the latency that is greater or equal than the given fraction of recorded latencies.
+     * @param fraction Fraction between 0 and 1 (e.g., 0.99 for the 99th percentile).
+     * @return Upper bound of the bucket holding the percentile; zero, when nothing was recorded.
+     */
+    [[nodiscard]] std::uint64_t percentile(const double fraction) const noexcept
+    {
+        // Buckets are read one by one; they may be updated concurrently.
+        auto counts = std::array<std::uint64_t, std::tuple_size<decltype(_buckets)>::value>{};
+        auto total = std::uint64_t{0U};
+        for (auto i = 0U; i < _buckets.size(); ++i)
+        {
+            counts[i] = _buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        if (total == 0U)
+        {
+            return 0U;
+        }
+
+        const auto rank = std::max(std::uint64_t(fraction * double(total) + 0.5), std::uint64_t(1U));
+        auto seen = std::uint64_t{0U};
+        for (auto i = 0U; i < counts.size(); ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                return LatencyHistogram::bucket_upper_bound(i);
+            }
+        }
+
+        return LatencyHistogram::bucket_upper_bound(counts.size() - 1U);
+    }
+
+    /**
+     * Adds the latencies recorded by another histogram, e.g., to merge the
+     * histograms of all channels. Only the recording thread may merge.
+     * @param other Histogram to add.
+     */
+    void merge(const LatencyHistogram &other) noexcept
+    {
+        for (auto i = 0U; i < _buckets.size(); ++i)
+        {
+            const auto count = other._buckets[i].load(std::memory_order_relaxed);
+            _buckets[i].store(_buckets[i].load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Resets all buckets; should only be called by the recording thread.
+     */
+    void clear() noexcept
+    {
+        for (auto &bucket : _buckets)
+        {
+            bucket.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Calculates the bucket for a latency.
+     * @param cycles Latency in cycles.
+     * @return Index of the bucket.
+     */
+    [[nodiscard]] static std::uint16_t bucket_index(const std::uint64_t cycles) noexcept
+    {
+        if (cycles < 4U)
+        {
+            return std::uint16_t(cycles);
+        }
+
+        // Two bits below the most significant bit select the bucket within the power of two.
+        const auto most_significant_bit = 63U - std::uint32_t(__builtin_clzll(cycles));
+        const auto sub_bucket = (cycles >> (most_significant_bit - 2U)) & 3U;
+        return std::uint16_t((most_significant_bit - 1U) * 4U + sub_bucket);
+    }
+
+    /**
+     * @param index Index of the bucket.
+     * @return Largest latency recorded into the bucket.
+     */
+    [[nodiscard]] static std::uint64_t bucket_upper_bound(const std::uint16_t index) noexcept
+    {
+        if (index < 4U)
+        {
+            return index;
+        }
+
+        const auto shift = index / 4U - 1U;
+        const auto lower_bound = std::uint64_t(4U + index % 4U) << shift;
+        return lower_bound + ((std::uint64_t(1U) << shift) - 1U);
+    }
+
+private:
+    // Four buckets for every power of two up to 2^63.
+    std::array<std::atomic_uint64_t, 252U> _buckets{};
+};
+
+/**
+ * Always-on metrics of a channel. Counters are updated relaxed; most of
+ * them are written only by the worker owning the channel, producers and
+ * thieves update a separate cache line. All counters can be read by any
+ * thread at any time, e.g., for polling a snapshot from a monitor thread.
+ */
+class ChannelMetrics
+{
+public:
+    constexpr ChannelMetrics() noexcept = default;
+    ~ChannelMetrics() noexcept = default;
+
+    /**
+     * Counts tasks pushed to the remote queues; called by any thread.
+     * @param count Number of tasks.
+     */
+    void enqueued_remote(const std::uint64_t count) noexcept
+    {
+        _enqueued_remote.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts tasks taken out of the remote queues by another channel; called by the thief.
+     * @param count Number of tasks.
+     */
+    void stolen_from(const std::uint64_t count) noexcept
+    {
+        _stolen_from.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Counts a task pushed to the local queues; called by the owning worker.
+     */
+    void enqueued_local() noexcept { ChannelMetrics::increment(_enqueued_local, 1U); }
+
+    /**
+     * Counts tasks stolen from other channels; called by the owning worker.
+     * @param count Number of tasks.
+     */
+    void stolen(const std::uint64_t count) noexcept { ChannelMetrics::increment(_stolen, count); }
+
+    /**
+     * Counts a fill of the task buffer; called by the owning worker.
+     */
+    void filled() noexcept { ChannelMetrics::increment(_fills, 1U); }
+
+    /**
+     * Counts an executed task; called by the owning worker.
+     * @param cycles Cycles spent for the task.
+     */
+    void executed(const std::uint64_t cycles) noexcept
+    {
+        ChannelMetrics::increment(_executed, 1U);
+        ChannelMetrics::increment(_busy_cycles, cycles);
+        _latency.record(cycles);
+    }
+
+    /**
+     * Counts a range of time the owning worker found no task; called by the owning worker.
+     * @param cycles Cycles from the first empty fill of the task buffer until the next non-empty fill.
+     */
+    void idled(const std::uint64_t cycles) noexcept
+    {
+        ChannelMetrics::increment(_idle_cycles, cycles);
+        _idle.record(cycles);
+    }
+
+    /**
+     * Marks the start of the owning worker, the origin for the idle ratio.
+     */
+    void started() noexcept { _start_timestamp.store(system::tsc::read(), std::memory_order_relaxed); }
+
+    /**
+     * @return Number of tasks waiting in the queues and the task buffer of the channel.
+     */
+    [[nodiscard]] std::uint64_t queue_depth() const noexcept
+    {
+        // Counters are read one after another; the depth is an estimation and must not fall below zero.
+        const auto incoming = _enqueued_remote.load(std::memory_order_relaxed) +
+                              _enqueued_local.load(std::memory_order_relaxed) +
+                              _stolen.load(std::memory_order_relaxed);
+        const auto outgoing = _executed.load(std::memory_order_relaxed) + _stolen_from.load(std::memory_order_relaxed);
+        return incoming > outgoing ? incoming - outgoing : 0U;
+    }
+
+    [[nodiscard]] std::uint64_t executed() const noexcept { return _executed.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t stolen() const noexcept { return _stolen.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t fills() const noexcept { return _fills.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t busy_cycles() const noexcept { return _busy_cycles.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t idle_cycles() const noexcept { return _idle_cycles.load(std::memory_order_relaxed); }
+    [[nodiscard]] const LatencyHistogram &latency() const noexcept { return _latency; }
+    [[nodiscard]] const LatencyHistogram &idle() const noexcept { return _idle; }
+
+    /**
+     * @param now Current value of the time stamp counter.
+     * @return Fraction of cycles since the start of the worker, the worker was not executing tasks.
+     */
+    [[nodiscard]] double idle_ratio(const std::uint64_t now) const noexcept
+    {
+        const auto start = _start_timestamp.load(std::memory_order_relaxed);
+        if (start == 0U || now <= start)
+        {
+            return 0.0;
+        }
+
+        const auto busy = double(this->busy_cycles()) / double(now - start);
+        return busy < 1.0 ? 1.0 - busy : 0.0;
+    }
+
+private:
+    // Counters written by producers and thieves.
+    alignas(64) std::atomic_uint64_t _enqueued_remote{0U};
+    std::atomic_uint64_t _stolen_from{0U};
+
+    // Counters written by the owning worker only.
+    alignas(64) std::atomic_uint64_t _enqueued_local{0U};
+    std::atomic_uint64_t _executed{0U};
+    std::atomic_uint64_t _stolen{0U};
+    std::atomic_uint64_t _fills{0U};
+    std::atomic_uint64_t _busy_cycles{0U};
+    std::atomic_uint64_t _idle_cycles{0U};
+    std::atomic_uint64_t _start_timestamp{0U};
+
+    // Cycles spent for executed tasks.
+    LatencyHistogram _latency;
+
+    // Cycles of every range the worker found no task.
+    LatencyHistogram _idle;
+
+    /**
+     * Increments a counter that is written by a single thread, avoiding atomic read-modify-write.
+     * @param counter Counter to increment.
+     * @param value Value to add.
+     */
+    static void increment(std::atomic_uint64_t &counter, const std::uint64_t value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Point-in-time view on the metrics of a channel.
+ */
+struct ChannelSnapshot
+{
+    // Id of the channel.
+    std::uint16_t channel_id;
+
+    // Tasks waiting in the queues and the task buffer.
+    std::uint64_t queue_depth;
+
+    // Tasks executed so far.
+    std::uint64_t executed;
+
+    // Tasks stolen from other channels so far.
+    std::uint64_t stolen;
+
+    // Fills of the task buffer so far.
+    std::uint64_t fills;
+
+    // Fraction of time since the start, the worker did not execute tasks.
+    double idle_ratio;
+
+    // Ranges of time the worker found no task and their cycles in total.
+    std::uint64_t idle_ranges;
+    std::uint64_t idle_cycles;
+
+    // Median and 99th percentile of the task latency in cycles.
+    std::uint64_t latency_p50;
+    std::uint64_t latency_p99;
+};
+} // namespace mx::tasking::profiling
\ No newline at end of file
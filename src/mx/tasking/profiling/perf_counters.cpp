@@ -0,0 +1,100 @@
+#include "perf_counters.h"
+#include <asm/unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace mx::tasking::profiling;
+
+bool PerfCounters::open() noexcept
+{
+#if defined(__x86_64__) || defined(__amd64__)
+    constexpr auto events = std::array<std::pair<std::uint32_t, std::uint64_t>, std::tuple_size_v<values_t>>{{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8U) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+    }};
+
+    const auto page_size = std::size_t(::sysconf(_SC_PAGESIZE));
+    auto group_leader = -1;
+    for (auto event = 0U; event < events.size(); ++event)
+    {
+        auto attribute = perf_event_attr{};
+        attribute.type = events[event].first;
+        attribute.size = sizeof(perf_event_attr);
+        attribute.config = events[event].second;
+        attribute.disabled = group_leader == -1;
+        attribute.exclude_kernel = true;
+        attribute.exclude_hv = true;
+
+        // Counters of the calling thread only, on any cpu.
+        const auto file_descriptor =
+            std::int32_t(::syscall(__NR_perf_event_open, &attribute, 0, -1, group_leader, 0));
+        if (file_descriptor < 0)
+        {
+            continue;
+        }
+
+        auto *page = ::mmap(nullptr, page_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+        if (page == MAP_FAILED)
+        {
+            ::close(file_descriptor);
+            continue;
+        }
+
+        this->_file_descriptors[event] = file_descriptor;
+        this->_pages[event] = reinterpret_cast<perf_event_mmap_page *>(page);
+        if (group_leader == -1)
+        {
+            group_leader = file_descriptor;
+        }
+    }
+
+    if (group_leader == -1)
+    {
+        return false;
+    }
+
+    ::ioctl(group_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    this->_is_open = true;
+
+    // Without user space access (e.g., forbidden by the kernel), reading would need system calls.
+    for (const auto *page : this->_pages)
+    {
+        if (page != nullptr && page->cap_user_rdpmc)
+        {
+            return true;
+        }
+    }
+
+    this->close();
+    return false;
+#else
+    return false;
+#endif
+}
+
+void PerfCounters::close() noexcept
+{
+    const auto page_size = std::size_t(::sysconf(_SC_PAGESIZE));
+    for (auto event = 0U; event < this->_file_descriptors.size(); ++event)
+    {
+        if (this->_pages[event] != nullptr)
+        {
+            ::munmap(this->_pages[event], page_size);
+            this->_pages[event] = nullptr;
+        }
+
+        if (this->_file_descriptors[event] >= 0)
+        {
+            ::close(this->_file_descriptors[event]);
+            this->_file_descriptors[event] = -1;
+        }
+    }
+
+    this->_is_open = false;
+}
\ No newline at end of file
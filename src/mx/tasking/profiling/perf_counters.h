@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <tuple>
+
+namespace mx::tasking::profiling {
+/**
+ * Group of hardware performance counters for the calling thread.
+ * The counters are opened by the worker thread itself and read from
+ * user space via rdpmc (no system call), cheap enough to read them
+ * before and after every task.
+ */
+class PerfCounters
+{
+public:
+    enum Event : std::uint8_t
+    {
+        Instructions,
+        Cycles,
+        L1Misses,
+        LLCMisses,
+        StalledCyclesBackend
+    };
+
+    using values_t = std::array<std::uint64_t, 5U>;
+
+    /**
+     * @return Names of all events, in order of the enum.
+     */
+    static constexpr std::array<const char *, std::tuple_size_v<values_t>> names() noexcept
+    {
+        return {"instructions", "cycles", "l1-misses", "llc-misses", "stalled-cycles-backend"};
+    }
+
+    constexpr PerfCounters() noexcept = default;
+    PerfCounters(const PerfCounters &) = delete;
+    ~PerfCounters() noexcept { close(); }
+
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * Opens and enables the counters for the calling thread. Events not
+     * supported by the cpu are left out and read as zero.
+     *
+     * @return True, if at least one counter can be read from user space.
+     */
+    bool open() noexcept;
+
+    /**
+     * Disables and closes all counters.
+     */
+    void close() noexcept;
+
+    /**
+     * @return True, if the counters are open.
+     */
+    [[nodiscard]] bool is_open() const noexcept { return _is_open; }
+
+    /**
+     * Reads all counters of the calling thread; only the
+     * thread that opened the counters is allowed to read.
+     *
+     * @param values Values of the counters, in order of the enum.
+     */
+    void read(values_t &values) const noexcept
+    {
+        for (auto event = 0U; event < values.size(); ++event)
+        {
+            values[event] = _pages[event] != nullptr ? PerfCounters::read(*_pages[event]) : 0U;
+        }
+    }
+
+private:
+    // File descriptors of the counters, -1 if not opened.
+    std::array<std::int32_t, std::tuple_size_v<values_t>> _file_descriptors{-1, -1, -1, -1, -1};
+
+    // Pages mapped from the kernel, publishing the hardware counter and its offset.
+    std::array<perf_event_mmap_page *, std::tuple_size_v<values_t>> _pages{nullptr};
+
+    bool _is_open{false};
+
+    /**
+     * Reads a single counter via rdpmc, retrying while
+     * the kernel updates the page (e.g., after a context switch).
+     *
+     * @param page Page of the counter.
+     * @return Value of the counter.
+     */
+    static std::uint64_t read(const perf_event_mmap_page &page) noexcept
+    {
+        std::uint32_t sequence;
+        std::uint64_t value;
+        do
+        {
+            sequence = page.lock;
+            asm volatile("" ::: "memory");
+
+            value = page.offset;
+            const auto index = page.index;
+            if (page.cap_user_rdpmc && index > 0U)
+            {
+                // The counter is only pmc_width bits wide; extend the sign.
+                const auto shift = 64U - page.pmc_width;
+                value += std::uint64_t(std::int64_t(PerfCounters::rdpmc(index - 1U) << shift) >> shift);
+            }
+
+            asm volatile("" ::: "memory");
+        } while (page.lock != sequence);
+
+        return value;
+    }
+
+    static std::uint64_t rdpmc([[maybe_unused]] const std::uint32_t counter) noexcept
+    {
+#if defined(__x86_64__) || defined(__amd64__)
+        return __builtin_ia32_rdpmc(int(counter));
+#else
+        return 0U;
+#endif
+    }
+};
+} // namespace mx::tasking::profiling
\ No newline at end of file
@@ -1,19 +1,196 @@
 #pragma once
+#include "counter_registry.h"
+#include "metrics.h"
+#include "perf_counters.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <memory>
 #include <mx/memory/global_heap.h>
+#include <mx/system/tsc.h>
 #include <mx/tasking/config.h>
-#include <mx/util/aligned_t.h>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 namespace mx::tasking::profiling {
+/**
+ * Latencies of a task type, merged over all channels.
+ */
+struct TaskLatency
+{
+    // Percentiles reported for queueing and execution time.
+    static constexpr auto percentiles = std::array<double, 4U>{0.5, 0.9, 0.99, 0.999};
+
+    // Demangled name of the task type.
+    std::string name;
+
+    // Number of executed tasks.
+    std::uint64_t count;
+
+    // Nanoseconds from spawning the task until its execution started (for every percentile).
+    std::array<std::uint64_t, percentiles.size()> queueing;
+
+    // Nanoseconds the task executed (for every percentile).
+    std::array<std::uint64_t, percentiles.size()> execution;
+
+    // Number of optimistic reads that had to be repeated, because the version changed.
+    std::uint64_t failed_validations;
+
+    // Hardware performance counters summed over all tasks (see PerfCounters::Event), zero if not recorded.
+    PerfCounters::values_t perf_counters;
+};
+
+/**
+ * Histograms of queueing and execution time for the task types
+ * executed by a single channel. Only the worker of the channel
+ * records, any thread may read.
+ */
+class alignas(64) TaskTypeLatencies
+{
+public:
+    struct Type
+    {
+        // Type of the task, set once when the first task of the type is recorded.
+        std::atomic<const std::type_info *> type{nullptr};
+
+        // Cycles from spawn to start.
+        LatencyHistogram queueing;
+
+        // Cycles of the execution.
+        LatencyHistogram execution;
+
+        // Failed validations of optimistic reads.
+        std::atomic_uint64_t failed_validations{0U};
+
+        // Hardware performance counters summed over all tasks.
+        std::array<std::atomic_uint64_t, std::tuple_size_v<PerfCounters::values_t>> perf_counters{};
+    };
+
+    constexpr TaskTypeLatencies() noexcept = default;
+    ~TaskTypeLatencies() noexcept = default;
+
+    /**
+     * Records the latencies of an executed task. When all slots are
+     * taken by other types, the latencies are not recorded.
+     *
+     * @param type Type of the task.
+     * @param queueing_cycles Cycles from spawn to start; zero if unknown.
+     * @param execution_cycles Cycles of the execution.
+     */
+    void record(const std::type_info &type, const std::uint64_t queueing_cycles,
+                const std::uint64_t execution_cycles) noexcept
+    {
+        auto *slot = this->find(type);
+        if (slot == nullptr)
+        {
+            return;
+        }
+
+        if (queueing_cycles > 0U)
+        {
+            slot->queueing.record(queueing_cycles);
+        }
+        slot->execution.record(execution_cycles);
+    }
+
+    /**
+     * Records failed validations of an optimistic read.
+     *
+     * @param type Type of the task.
+     * @param count Number of failed validations.
+     */
+    void record_failed_validations(const std::type_info &type, const std::uint64_t count) noexcept
+    {
+        auto *slot = this->find(type);
+        if (slot != nullptr)
+        {
+            const auto failed_validations = slot->failed_validations.load(std::memory_order_relaxed);
+            slot->failed_validations.store(failed_validations + count, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Records the hardware performance counters measured during the execution of a task.
+     *
+     * @param type Type of the task.
+     * @param perf_counters Difference of the counters before and after the execution.
+     */
+    void record_perf_counters(const std::type_info &type, const PerfCounters::values_t &perf_counters) noexcept
+    {
+        auto *slot = this->find(type);
+        if (slot != nullptr)
+        {
+            for (auto event = 0U; event < perf_counters.size(); ++event)
+            {
+                const auto value = slot->perf_counters[event].load(std::memory_order_relaxed);
+                slot->perf_counters[event].store(value + perf_counters[event], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] const std::array<Type, config::task_statistics_types()> &types() const noexcept { return _types; }
+
+    void clear() noexcept
+    {
+        for (auto &slot : _types)
+        {
+            slot.type.store(nullptr, std::memory_order_relaxed);
+            slot.queueing.clear();
+            slot.execution.clear();
+            slot.failed_validations.store(0U, std::memory_order_relaxed);
+            for (auto &perf_counter : slot.perf_counters)
+            {
+                perf_counter.store(0U, std::memory_order_relaxed);
+            }
+        }
+        _last_type = 0U;
+    }
+
+private:
+    std::array<Type, config::task_statistics_types()> _types{};
+    std::uint16_t _last_type{0U};
+
+    Type *find(const std::type_info &type) noexcept
+    {
+        // Most channels execute few types in bursts; try the last one first.
+        if (_types[_last_type].type.load(std::memory_order_relaxed) == &type)
+        {
+            return &_types[_last_type];
+        }
+
+        for (auto i = 0U; i < _types.size(); ++i)
+        {
+            const auto *slot_type = _types[i].type.load(std::memory_order_relaxed);
+            if (slot_type == nullptr)
+            {
+                _types[i].type.store(&type, std::memory_order_release);
+            }
+
+            if (slot_type == nullptr || slot_type == &type || *slot_type == type)
+            {
+                _last_type = std::uint16_t(i);
+                return &_types[i];
+            }
+        }
+
+        return nullptr;
+    }
+};
+
 /**
  * Collector for tasking statistics (scheduled tasks, executed tasks, ...).
+ * The built-in counters are the first counters of the registry, further
+ * counters can be registered by applications.
  */
 class Statistic
 {
 public:
-    using counter_line_t = util::aligned_t<std::array<std::uint64_t, 7>>;
-
     enum Counter : std::uint8_t
     {
         Scheduled,
@@ -22,19 +199,32 @@ public:
         Executed,
         ExecutedReader,
         ExecutedWriter,
-        Fill
+        Fill,
+        Stolen,
+        FailedValidations,
+        ValidationFallbacks
     };
 
-    explicit Statistic(const std::uint16_t count_channels) noexcept : _count_channels(count_channels)
+    explicit Statistic(const std::uint16_t count_channels) : _count_channels(count_channels), _counters(count_channels)
     {
-        this->_counter = new (memory::GlobalHeap::allocate_cache_line_aligned(sizeof(counter_line_t) * count_channels))
-            counter_line_t[count_channels];
-        std::memset(static_cast<void *>(this->_counter), 0, sizeof(counter_line_t) * count_channels);
+        for (const auto *name : {"scheduled", "scheduled-on-channel", "scheduled-off-channel", "executed",
+                                 "executed-reader", "executed-writer", "fill", "stolen", "failed-validations",
+                                 "validation-fallbacks"})
+        {
+            this->_counters.register_counter(name);
+        }
+
+        this->_latencies = new (memory::GlobalHeap::allocate_cache_line_aligned(sizeof(TaskTypeLatencies) *
+                                                                                count_channels))
+            TaskTypeLatencies[count_channels];
     }
 
     Statistic(const Statistic &) = delete;
 
-    ~Statistic() noexcept { delete[] this->_counter; }
+    ~Statistic() noexcept
+    {
+        delete[] this->_latencies;
+    }
 
     Statistic &operator=(const Statistic &) = delete;
 
@@ -43,7 +233,130 @@ public:
      */
     void clear() noexcept
     {
-        std::memset(static_cast<void *>(this->_counter), 0, sizeof(counter_line_t) * this->_count_channels);
+        this->_counters.clear();
+        for (auto i = 0U; i < this->_count_channels; ++i)
+        {
+            this->_latencies[i].clear();
+        }
+    }
+
+    /**
+     * Records queueing and execution time of a task executed by the given channel.
+     * @param channel_id Channel that executed the task.
+     * @param type Type of the task.
+     * @param queueing_cycles Cycles from spawn to start; zero if unknown.
+     * @param execution_cycles Cycles of the execution.
+     */
+    void record_latency(const std::uint16_t channel_id, const std::type_info &type,
+                        const std::uint64_t queueing_cycles, const std::uint64_t execution_cycles) noexcept
+    {
+        this->_latencies[channel_id].record(type, queueing_cycles, execution_cycles);
+    }
+
+    /**
+     * Records failed validations of an optimistic read executed by the given channel.
+     * @param channel_id Channel that executed the task.
+     * @param type Type of the task.
+     * @param count Number of failed validations.
+     */
+    void record_failed_validations(const std::uint16_t channel_id, const std::type_info &type,
+                                   const std::uint64_t count) noexcept
+    {
+        this->_latencies[channel_id].record_failed_validations(type, count);
+    }
+
+    /**
+     * Records the hardware performance counters of a task executed by the given channel.
+     * @param channel_id Channel that executed the task.
+     * @param type Type of the task.
+     * @param perf_counters Difference of the counters before and after the execution.
+     */
+    void record_perf_counters(const std::uint16_t channel_id, const std::type_info &type,
+                              const PerfCounters::values_t &perf_counters) noexcept
+    {
+        this->_latencies[channel_id].record_perf_counters(type, perf_counters);
+    }
+
+    /**
+     * Sums the hardware performance counters of all task types executed by the given channel.
+     * @param channel_id Channel that executed the tasks.
+     * @return Counters summed over all tasks (see PerfCounters::Event).
+     */
+    [[nodiscard]] PerfCounters::values_t perf_counters(const std::uint16_t channel_id) const noexcept
+    {
+        auto perf_counters = PerfCounters::values_t{};
+        for (const auto &slot : this->_latencies[channel_id].types())
+        {
+            for (auto event = 0U; event < perf_counters.size(); ++event)
+            {
+                perf_counters[event] += slot.perf_counters[event].load(std::memory_order_relaxed);
+            }
+        }
+
+        return perf_counters;
+    }
+
+    /**
+     * Merges the latencies of all channels per task type.
+     * @return Latencies for every recorded task type.
+     */
+    [[nodiscard]] std::vector<TaskLatency> latencies() const
+    {
+        // Histograms of all channels, merged per type.
+        auto merged = std::vector<std::pair<const std::type_info *, std::unique_ptr<TaskTypeLatencies::Type>>>{};
+        for (auto channel_id = 0U; channel_id < this->_count_channels; ++channel_id)
+        {
+            for (const auto &slot : this->_latencies[channel_id].types())
+            {
+                const auto *type = slot.type.load(std::memory_order_acquire);
+                if (type == nullptr)
+                {
+                    continue;
+                }
+
+                auto iterator = std::find_if(merged.begin(), merged.end(),
+                                             [type](const auto &item) { return *item.first == *type; });
+                if (iterator == merged.end())
+                {
+                    iterator = merged.emplace(merged.end(), type, std::make_unique<TaskTypeLatencies::Type>());
+                }
+                iterator->second->queueing.merge(slot.queueing);
+                iterator->second->execution.merge(slot.execution);
+                iterator->second->failed_validations.fetch_add(
+                    slot.failed_validations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                for (auto event = 0U; event < slot.perf_counters.size(); ++event)
+                {
+                    iterator->second->perf_counters[event].fetch_add(
+                        slot.perf_counters[event].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        auto latencies = std::vector<TaskLatency>{};
+        latencies.reserve(merged.size());
+        for (const auto &[type, histograms] : merged)
+        {
+            auto *demangled_name = abi::__cxa_demangle(type->name(), nullptr, nullptr, nullptr);
+            auto &latency = latencies.emplace_back(TaskLatency{
+                demangled_name != nullptr ? demangled_name : type->name(), histograms->execution.count(), {}, {},
+                histograms->failed_validations.load(std::memory_order_relaxed), {}});
+            std::free(demangled_name);
+
+            for (auto event = 0U; event < latency.perf_counters.size(); ++event)
+            {
+                latency.perf_counters[event] = histograms->perf_counters[event].load(std::memory_order_relaxed);
+            }
+
+            for (auto i = 0U; i < TaskLatency::percentiles.size(); ++i)
+            {
+                latency.queueing[i] =
+                    system::tsc::to_nanoseconds(histograms->queueing.percentile(TaskLatency::percentiles[i]));
+                latency.execution[i] =
+                    system::tsc::to_nanoseconds(histograms->execution.percentile(TaskLatency::percentiles[i]));
+            }
+        }
+
+        return latencies;
     }
 
     /**
@@ -52,9 +365,25 @@ public:
      */
     template <Counter C> void increment(const std::uint16_t channel_id) noexcept
     {
-        _counter[channel_id].value()[static_cast<std::uint8_t>(C)] += 1;
+        this->_counters.increment(channel_id, C);
+    }
+
+    /**
+     * Increment the template-given counter by a given value for the given channel.
+     * @param channel_id Channel to increment the statistics for.
+     * @param value Value to add.
+     */
+    template <Counter C> void increment(const std::uint16_t channel_id, const std::uint64_t value) noexcept
+    {
+        this->_counters.increment(channel_id, C, value);
     }
 
+    /**
+     * Increment the template-given counter by one from a thread that is not
+     * the worker of a channel (e.g., spawning tasks from outside the runtime).
+     */
+    template <Counter C> void increment_shared() noexcept { this->_counters.increment_shared(C); }
+
     /**
      * Read the given counter for a given channel.
      * @param counter Counter to read.
@@ -63,7 +392,7 @@ public:
      */
     [[nodiscard]] std::uint64_t get(const Counter counter, const std::uint16_t channel_id) const noexcept
     {
-        return _counter[channel_id].value()[static_cast<std::uint8_t>(counter)];
+        return this->_counters.get(counter, channel_id);
     }
 
     /**
@@ -71,22 +400,26 @@ public:
      * @param counter Counter to read.
      * @return Value of the counter for all channels.
      */
-    [[nodiscard]] std::uint64_t get(const Counter counter) const noexcept
-    {
-        std::uint64_t sum = 0U;
-        for (auto i = 0U; i < _count_channels; ++i)
-        {
-            sum += get(counter, i);
-        }
+    [[nodiscard]] std::uint64_t get(const Counter counter) const noexcept { return this->_counters.get(counter); }
 
-        return sum;
-    }
+    /**
+     * @return Registry of the built-in and application defined counters.
+     */
+    [[nodiscard]] CounterRegistry &counters() noexcept { return this->_counters; }
+
+    /**
+     * @return Registry of the built-in and application defined counters.
+     */
+    [[nodiscard]] const CounterRegistry &counters() const noexcept { return this->_counters; }
 
 private:
     // Number of channels to monitor.
     const std::uint16_t _count_channels;
 
-    // Memory for storing the counter.
-    counter_line_t *_counter = nullptr;
+    // Counters of every channel.
+    CounterRegistry _counters;
+
+    // Latencies of task types for every channel.
+    TaskTypeLatencies *_latencies = nullptr;
 };
 } // namespace mx::tasking::profiling
\ No newline at end of file
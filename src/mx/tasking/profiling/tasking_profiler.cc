@@ -1,323 +1,286 @@
 #include "tasking_profiler.h"
 
+#include <algorithm>
 #include <iostream>
 #include <chrono>
-#include <numeric>
+#include <cstdlib>
+#include <cstring>
 #include <cxxabi.h>
-#include <numa.h>
+#include <numeric>
 
-constexpr std::chrono::time_point<std::chrono::high_resolution_clock> TaskingProfiler::tinit;
+namespace trace = mx::tasking::profiling::trace;
 
-void printFloatUS(std::uint64_t ns)
+void TaskingProfiler::init(std::uint16_t corenum, std::string trace_file_name)
 {
-    std::uint64_t remainder = ns % 1000;
-    std::uint64_t front = ns / 1000;
-    char strRemainder[4];
-    
-    for(int i = 2; i >= 0; i--)
+    stopDrainer();
+
+    //calibrate the time stamp counter before profiling
+    mx::system::tsc::ticks_per_nanosecond();
+    relTime = now();
+    taskQueueOverhead = 0;
+
+    corenum++;
+    this->total_cores = corenum;
+    this->trace_file = std::move(trace_file_name);
+
+    buffers.clear();
+    running_tasks = std::make_unique<running_task[]>(total_cores);
+    names.clear();
+    {
+        std::lock_guard<std::mutex> _{task_types_latch};
+        task_types.clear();
+    }
+    last_timestamp.assign(total_cores, 0);
+    task_counter.assign(total_cores, 0);
+    dropped = 0;
+
+    for (std::uint16_t i = 0; i < total_cores; i++)
     {
-        strRemainder[i] = '0' + (remainder % 10);
-        remainder /= 10;
+        buffers.emplace_back(std::make_unique<mx::util::BoundMPMCQueue<record>>(
+            mx::tasking::config::tasking_profiler_buffer_size()));
+        running_tasks[i] = {0, 0, nullptr, 0, 1, 0, 0};
     }
-    strRemainder[3] = '\0';
 
-    std::cout << front << '.' << strRemainder;
+    if(trace.open(this->trace_file, total_cores) == false)
+    {
+        std::cerr << "Could not open profiling trace " << this->trace_file << std::endl;
+    }
+
+    //stream the buffers to the trace until the profile is saved
+    is_draining = true;
+    drainer = std::thread([this] {
+        while(is_draining.load(std::memory_order_relaxed))
+        {
+            if(drain() == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    });
 }
 
-void TaskingProfiler::init(std::uint16_t corenum)
+std::uint64_t TaskingProfiler::toNanoseconds(std::uint64_t timestamp) const
 {
-    relTime = std::chrono::high_resolution_clock::now();
+    return mx::system::tsc::to_nanoseconds(timestamp > relTime ? timestamp - relTime : 0);
+}
 
-    corenum++;
-    this->total_cores = corenum;
-    uint16_t cpu_numa_node = 0;
+void TaskingProfiler::push(std::uint16_t cpu_core, const record& rec)
+{
+    if(buffers[cpu_core]->try_push_back(rec) == false)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-    //create an array of pointers to task_info structs
-    task_data = new task_info*[total_cores];
-    
-    for (std::uint8_t i = 0; i < total_cores; i++)
+std::uint64_t TaskingProfiler::drain()
+{
+    std::uint64_t drained = 0;
+    record rec;
+    for(std::uint16_t cpu_id = 0; cpu_id < total_cores; cpu_id++)
     {
-        cpu_numa_node = numa_node_of_cpu(i);
-        task_data[i] = static_cast<task_info*>(numa_alloc_onnode(sizeof(task_info) * mx::tasking::config::tasking_array_length(), cpu_numa_node));
-        for(size_t j = mx::tasking::config::tasking_array_length(); j > 0; j--)
+        while(buffers[cpu_id]->try_pop_front(rec))
         {
-            task_data[i][j] = {0, 0, NULL, tinit, tinit};
+            drained++;
+
+            const std::uint64_t duration = mx::system::tsc::to_nanoseconds(rec.end - rec.start);
+            if(rec.kind == Task)
+            {
+                std::lock_guard<std::mutex> _{task_types_latch};
+                task_type_aggregate& aggregate = task_types[rec.name];
+                aggregate.count++;
+                aggregate.total += duration;
+                aggregate.min = std::min(aggregate.min, duration);
+                aggregate.max = std::max(aggregate.max, duration);
+                aggregate.histogram.record(duration);
+            }
+
+            if(trace.is_open() == false)
+            {
+                continue;
+            }
+
+            const std::uint64_t start = toNanoseconds(rec.start);
+            const std::int64_t delta = std::int64_t(start - last_timestamp[cpu_id]);
+            last_timestamp[cpu_id] = start;
+
+            if(rec.kind == Enqueue)
+            {
+                trace.write_tag(trace::Enqueue);
+                trace.write_varint(cpu_id);
+                trace.write_varint(trace::zigzag_encode(delta));
+                continue;
+            }
+
+            //task names are written once and referenced by their id
+            auto name = names.find(rec.name);
+            if(name == names.end())
+            {
+                name = names.emplace(rec.name, names.size()).first;
+                const std::size_t length = std::strlen(rec.name);
+                trace.write_tag(trace::Name);
+                trace.write_varint(name->second);
+                trace.write_varint(length);
+                trace.write(rec.name, length);
+            }
+
+            trace.write_tag(trace::Task);
+            trace.write_varint(cpu_id);
+            trace.write_varint(name->second);
+            trace.write_varint(rec.type);
+            trace.write_varint(trace::zigzag_encode(delta));
+            trace.write_varint(duration);
+            task_counter[cpu_id]++;
         }
     }
 
-    //create an array of pointers to queue_info structs
-    queue_data = new queue_info*[total_cores];
-    for (std::uint16_t i = 0; i < total_cores; i++)
+    return drained;
+}
+
+void TaskingProfiler::stopDrainer()
+{
+    if(drainer.joinable())
     {
-        cpu_numa_node = numa_node_of_cpu(i);
-        queue_data[i] = static_cast<queue_info*>(numa_alloc_onnode(sizeof(queue_info) * mx::tasking::config::tasking_array_length(), cpu_numa_node));
-        for(size_t j = mx::tasking::config::tasking_array_length(); j > 0; j--)
+        is_draining = false;
+        drainer.join();
+
+        //records pushed after the last round of the drainer
+        drain();
+    }
+}
+
+void TaskingProfiler::sample(std::uint32_t every_nth_task, std::uint64_t interval_ns)
+{
+    sample_every.store(std::max(every_nth_task, std::uint32_t(1)), std::memory_order_relaxed);
+    sample_interval.store(std::uint64_t(double(interval_ns) * mx::system::tsc::ticks_per_nanosecond()),
+                          std::memory_order_relaxed);
+}
+
+std::vector<TaskingProfiler::task_type_profile> TaskingProfiler::taskTypes() const
+{
+    std::vector<task_type_profile> profiles;
+    {
+        std::lock_guard<std::mutex> _{task_types_latch};
+        profiles.reserve(task_types.size());
+        for(const auto& [name, aggregate] : task_types)
         {
-            queue_data[i][j] = {0, tinit};
+            //percentiles are upper bounds of histogram buckets
+            profiles.push_back({name, aggregate.count, aggregate.total, aggregate.min, aggregate.max,
+                                std::min(aggregate.histogram.percentile(0.5), aggregate.max),
+                                std::min(aggregate.histogram.percentile(0.99), aggregate.max)});
         }
     }
 
-    task_id_counter = new std::uint64_t[total_cores]{0};
-    queue_id_counter = new std::uint64_t[total_cores]{0};
+    std::sort(profiles.begin(), profiles.end(), [](const auto& left, const auto& right) { return left.total > right.total; });
+    return profiles;
 }
 
 std::uint64_t TaskingProfiler::startTask(std::uint16_t cpu_core, std::uint32_t type, const char* name)
 {
-    std::chrono::time_point<std::chrono::high_resolution_clock> start = std::chrono::high_resolution_clock::now();
-    const std::uint16_t cpu_id = cpu_core;
-    const std::uint64_t tid = task_id_counter[cpu_id]++;
-    task_info& ti = task_data[cpu_id][tid];
+    running_task& rt = running_tasks[cpu_core];
+
+    //skip tasks between two samples
+    if(--rt.countdown > 0)
+    {
+        return 0;
+    }
+    rt.countdown = sample_every.load(std::memory_order_relaxed);
+
+    //the interval is applied to the last sample, changing it takes effect immediately
+    const std::uint64_t start = now();
+    if(start - rt.last_sample < sample_interval.load(std::memory_order_relaxed))
+    {
+        return 0;
+    }
+    rt.last_sample = start;
 
-    ti.id = tid;
-    ti.type = type;
-    ti.name = name;
-    ti._start = start;
+    rt.id++;
+    rt.type = type;
+    rt.name = name;
+    rt.start = start;
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> end = std::chrono::high_resolution_clock::now();
-    overhead += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    rt.overhead += now() - start;
 
-    return ti.id;
+    return rt.id;
 }
 
 void TaskingProfiler::endTask(std::uint16_t cpu_core, std::uint64_t id)
 {
-    std::chrono::time_point<std::chrono::high_resolution_clock> start = std::chrono::high_resolution_clock::now();
+    if(id == 0)
+    {
+        return;
+    }
 
-    task_info& ti = task_data[cpu_core][id];
-    ti._end = std::chrono::high_resolution_clock::now();
+    const std::uint64_t end = now();
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> end = std::chrono::high_resolution_clock::now();
-    overhead += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    running_task& rt = running_tasks[cpu_core];
+    if(rt.id == id)
+    {
+        push(cpu_core, {rt.start, end, rt.name, rt.type, Task});
+    }
+
+    rt.overhead += now() - end;
 }
 
 void TaskingProfiler::enqueue(std::uint16_t corenum){
-    std::chrono::time_point<std::chrono::high_resolution_clock> timestamp = std::chrono::high_resolution_clock::now();
-    const std::uint64_t qid = __atomic_add_fetch(&queue_id_counter[corenum], 1, __ATOMIC_SEQ_CST);
+    if(isSampling())
+    {
+        return;
+    }
 
-    queue_info& qi = queue_data[corenum][qid];
-    qi.id = qid;
-    qi.timestamp = timestamp;
+    const std::uint64_t timestamp = now();
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> endTimestamp = std::chrono::high_resolution_clock::now();
-    taskQueueOverhead += std::chrono::duration_cast<std::chrono::nanoseconds>(endTimestamp - timestamp).count();
+    push(corenum, {timestamp, timestamp, nullptr, 0, Enqueue});
+
+    taskQueueOverhead.fetch_add(now() - timestamp, std::memory_order_relaxed);
 }
 
 void TaskingProfiler::saveProfile()
 {   
-    std::uint64_t overhead_ms = overhead/1000000;
-    std::cout << "Overhead-Time: " << overhead << "ns in ms: " << overhead_ms << "ms" << std::endl;
-    std::uint64_t taskQueueOverhead_ms = taskQueueOverhead/1000000;
-    std::cout << "TaskQueueOverhead-Time: " << taskQueueOverhead << "ns in ms: " << taskQueueOverhead_ms << "ms" << std::endl;
-
-    //get the number of tasks overal
-    std::uint64_t tasknum = 0;
-    for (std::uint16_t i = 0; i < total_cores; i++)
+    if(total_cores == 0)
     {
-        tasknum += task_id_counter[i];
+        return;
     }
-    std::cout << "Number of tasks: " << tasknum << std::endl;
-    std::cout << "Overhead-Time per Task: " << overhead/tasknum << "ns" << std::endl;
-
-    bool first = false;
-    std::uint64_t firstTime = 0;
-    std::uint64_t throughput = 0;
-    std::uint64_t duration = 0;
-    std::uint64_t lastEndTime = 0;
-    std::uint64_t taskQueueLength;
 
-    std::uint64_t timestamp = 0;
-    std::uint64_t start = 0;
-    std::uint64_t end = 0;
-    char* name;
+    //at most one buffer per core is left to write, the trace is converted offline
+    stopDrainer();
+    trace.close();
 
-    std::uint64_t taskCounter = 0;
-    std::uint64_t queueCounter = 0;
-
-    std::cout << "--Save--" << std::endl;
-    std::cout << "{\"traceEvents\":[" << std::endl;
-
-    //Events
+    std::uint64_t overhead = 0;
     for(std::uint16_t cpu_id = 0; cpu_id < total_cores; cpu_id++)
     {
-        //Metadata Events for each core (CPU instead of process as name,...)
-        std::cout << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << cpu_id << ",\"tid\":" << cpu_id << ",\"args\":{\"name\":\"CPU\"}}," << std::endl;
-        std::cout << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << cpu_id << ",\"tid\":" << cpu_id << ",\"args\":{\"name\":" << cpu_id << "}}," << std::endl;
-        
-
-
-        if (mx::tasking::config::use_task_queue_length()){
-            taskQueueLength = 0;
-            taskCounter = 0;
-            queueCounter = 1;
-
-            //Initial taskQueueLength is zero
-            std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-            printFloatUS(0);
-            std::cout << ",\"args\":{\"TaskQueueLength\":" << taskQueueLength << "}}," << std::endl;
-
-            //go through all tasks and queues
-            while(taskCounter<task_id_counter[cpu_id] || queueCounter<queue_id_counter[cpu_id]){
-                //get the next task and queue
-                queue_info& qi = queue_data[cpu_id][queueCounter];
-                task_info& ti = task_data[cpu_id][taskCounter];
-
-                //get the time from the queue element if existing
-                if(queueCounter < queue_id_counter[cpu_id]){
-                    timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(qi.timestamp - relTime).count();
-                }
-
-                //get the time's from the task element if existing
-                if(taskCounter < task_id_counter[cpu_id]){
-                    start = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._start - relTime).count();
-                    end = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._end - relTime).count();
-                    name = abi::__cxa_demangle(ti.name, 0, 0, 0);
-                }
-
-                //get the first time
-                if(!first){
-                    first = true;
-                    if(timestamp < start){
-                        firstTime = timestamp;
-                    }
-                    else{
-                        firstTime = start;
-                    }
-                }
-                //if the queue element is before the task element, it is an enqueue
-                if(qi.timestamp < ti._start && queueCounter <= queue_id_counter[cpu_id]){
-                    queueCounter++;
-                    taskQueueLength++;
-                    std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                    if(timestamp - firstTime == 0){
-                        printFloatUS(10);
-                    }
-                    else{
-                        printFloatUS(timestamp-firstTime);
-                    }
-                    std::cout << ",\"args\":{\"TaskQueueLength\":" << taskQueueLength << "}}," << std::endl;
-
-                }
-                //else we print the task itself and a dequeue
-                else{
-                    taskCounter++;
-                    taskQueueLength--;
-
-                    //taskQueueLength
-                    std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                    printFloatUS(start-firstTime);
-                    std::cout << ",\"args\":{\"TaskQueueLength\":" << taskQueueLength << "}}," << std::endl;
-
-                    //if the endtime of the last task is too large (cannot display right)
-                    if(taskCounter == task_id_counter[cpu_id] && ti._end == tinit){
-                        end = start + 1000;
-                    }
-                    //Task itself
-                    std::cout << "{\"pid\":" << cpu_id << ",\"tid\":" << cpu_id << ",\"ts\":";
-                    printFloatUS(start-firstTime);
-                    std::cout << ",\"dur\":";
-                    printFloatUS(end-start);
-                    std::cout << ",\"ph\":\"X\",\"name\":\"" << name << "\",\"args\":{\"type\":" << ti.type << "}}," << std::endl;
-
-                    //reset throughput if there is a gap of more than 1us
-                    if (start - lastEndTime > 1000 && lastEndTime != 0){
-                        std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                        printFloatUS(lastEndTime - firstTime);
-                        std::cout << ",\"args\":{\"TaskThroughput\":";
-                        //Tasks per microsecond is zero
-                        std::cout << 0;
-                        std::cout << "}}," << std::endl;
-                    }
-                    duration = end - start;
-
-                    //Task Throughput
-                    std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                    printFloatUS(start-firstTime);
-                    std::cout << ",\"args\":{\"TaskThroughput\":";
-                    //Tasks per microsecond
-                    throughput = 1000/duration;
-                    std::cout << throughput;
-                    std::cout << "}}," << std::endl;
-                    lastEndTime = end;
-                }
-            }
-        }
-        else{
-            for(std::uint32_t i = 0; i < task_id_counter[cpu_id]; i++){
-                task_info& ti = task_data[cpu_id][i];
-
-                // check if task is valid
-                if(ti._end == tinit)
-                {
-                    continue;
-                }
-                start = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._start - relTime).count();
-                end = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._end - relTime).count();
-                name = abi::__cxa_demangle(ti.name, 0, 0, 0);
-
-                //Task itself
-                std::cout << "{\"pid\":" << cpu_id << ",\"tid\":" << cpu_id << ",\"ts\":";
-                printFloatUS(start-firstTime);
-                std::cout << ",\"dur\":";
-                printFloatUS(end-start);
-                std::cout << ",\"ph\":\"X\",\"name\":\"" << name << "\",\"args\":{\"type\":" << ti.type << "}}," << std::endl;
-                    
-                //reset throughput if there is a gap of more than 1us
-                if (start - lastEndTime > 1000){
-                    std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                    printFloatUS(lastEndTime-firstTime);
-                    std::cout << ",\"args\":{\"TaskThroughput\":";
-                    //Tasks per microsecond is zero
-                    std::cout << 0;
-                    std::cout << "}}," << std::endl;
-                }
-                duration = end - start;
-
-                //Task Throughput
-                std::cout << "{\"pid\":" << cpu_id << ",\"name\":\"CPU" << cpu_id <<  "\",\"ph\":\"C\",\"ts\":";
-                printFloatUS(start-firstTime);
-                std::cout << ",\"args\":{\"TaskThroughput\":";
-
-                //Tasks per microsecond
-                throughput = 1000/duration;
-
-                std::cout << throughput;
-                std::cout << "}}," << std::endl;
-                lastEndTime = end;
-            }
-        }
-        lastEndTime = 0;
+        overhead += running_tasks[cpu_id].overhead;
     }
-            //sample Task (so we dont need to remove the last comma)
-            std::cout << "{\"name\":\"sample\",\"ph\":\"P\",\"ts\":0,\"pid\":5,\"tid\":0}";
-            std::cout << "]}" << std::endl;;        
-}
-
-
-
-//Code for the TaskingProfiler::printTP function
-/*
-void TaskingProfiler::printTP(std::uint64_t start, std::uint64_t end)
-{
-    std::uint64_t tp[total_cores]{0};
+    overhead = mx::system::tsc::to_nanoseconds(overhead);
+    std::uint64_t overhead_ms = overhead/1000000;
+    std::cout << "Overhead-Time: " << overhead << "ns in ms: " << overhead_ms << "ms" << std::endl;
+    std::uint64_t queueOverhead = mx::system::tsc::to_nanoseconds(taskQueueOverhead);
+    std::uint64_t queueOverhead_ms = queueOverhead/1000000;
+    std::cout << "TaskQueueOverhead-Time: " << queueOverhead << "ns in ms: " << queueOverhead_ms << "ms" << std::endl;
 
-    for(std::uint16_t cpu_id = 0; cpu_id < total_cores; cpu_id++)
+    //get the number of tasks overal
+    std::uint64_t tasknum = std::accumulate(task_counter.begin(), task_counter.end(), std::uint64_t(0));
+    std::cout << "Number of tasks: " << tasknum << std::endl;
+    std::cout << "Overhead-Time per Task: " << overhead/std::max(tasknum, std::uint64_t(1)) << "ns" << std::endl;
+    std::cout << "Dropped records: " << dropped << std::endl;
+    if(isSampling())
     {
-        // get the task_info array for the current core
-        task_info* core_data = task_data[cpu_id];
-
-        // get the id counter for the current core
-        for(std::uint64_t i = 0; i < task_id_counter[cpu_id]; i++)
+        std::cout << "Sampled every " << sample_every << ". task";
+        if(sample_interval > 0)
         {
-            task_info& ti = core_data[i];
-            const std::uint64_t tstart = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._start - relTime).count();
-            const std::uint64_t tend = std::chrono::duration_cast<std::chrono::nanoseconds>(ti._end - relTime).count();            
-            if(tstart > start && tend < end) {
-                tp[cpu_id]++;
-            }
+            std::cout << ", at most every " << mx::system::tsc::to_nanoseconds(sample_interval) << "ns";
         }
+        std::cout << " per core" << std::endl;
+    }
 
-        LOG_INFO("TP " << cpu_id << " " << tp[cpu_id]);
+    //durations of every task type
+    for(const auto& task_type : taskTypes())
+    {
+        char* name = abi::__cxa_demangle(task_type.name, 0, 0, 0);
+        std::cout << (name != nullptr ? name : task_type.name) << ": count " << task_type.count << ", total "
+                  << task_type.total << "ns, min " << task_type.min << "ns, p50 " << task_type.p50 << "ns, p99 "
+                  << task_type.p99 << "ns, max " << task_type.max << "ns" << std::endl;
+        std::free(name);
     }
-    LOG_INFO("TP " << "total " << std::accumulate(tp, tp + total_cores, 0));
-}
-*/
+
+    std::cout << "Trace: " << trace_file << " (convert using 'mxtrace " << trace_file << "')" << std::endl;
+}
\ No newline at end of file
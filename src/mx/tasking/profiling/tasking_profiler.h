@@ -1,7 +1,18 @@
 #pragma once
 #include <chrono>
 #include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <mx/tasking/config.h>
+#include <mx/system/tsc.h>
+#include <mx/tasking/profiling/metrics.h>
+#include <mx/tasking/profiling/trace_format.h>
+#include <mx/util/bound_mpmc_queue.h>
 
 
 class TaskingProfiler
@@ -9,88 +20,216 @@ class TaskingProfiler
 public:
     static TaskingProfiler& getInstance()
     {
-        static TaskingProfiler instance;
-        return instance;
+        // Never destroyed: the scheduler saves the profile during static destruction.
+        static TaskingProfiler* instance = new TaskingProfiler();
+        return *instance;
     }
 
-    struct task_info
+    enum record_kind : std::uint32_t
     {
-        std::uint64_t id;
-        std::uint32_t type;
+        Task = 0U,
+        Enqueue = 1U
+    };
+
+    /**
+     * Record of an executed task or an enqueue event, buffered per
+     * core and streamed to the trace by the drainer thread. Times are
+     * timestamps of the time stamp counter, the drainer converts them
+     * to nanoseconds relative to the initialization of the profiler.
+     */
+    struct record
+    {
+        std::uint64_t start;
+        std::uint64_t end;
         const char* name;
-        std::chrono::high_resolution_clock::time_point _start;
-        std::chrono::high_resolution_clock::time_point _end;
+        std::uint32_t type;
+        record_kind kind;
     };
-    
-    struct queue_info
+
+    /**
+     * Durations (in nanoseconds) of all recorded tasks of a type.
+     */
+    struct task_type_profile
     {
-        std::uint64_t id;
-        std::chrono::high_resolution_clock::time_point timestamp;
+        const char* name;
+        std::uint64_t count;
+        std::uint64_t total;
+        std::uint64_t min;
+        std::uint64_t max;
+        std::uint64_t p50;
+        std::uint64_t p99;
     };
 
 private:
     TaskingProfiler() {};
-    std::chrono::time_point<std::chrono::high_resolution_clock> relTime;
-    std::atomic<std::uint64_t> overhead{0};
+    std::uint64_t relTime{0};
     std::atomic<std::uint64_t> taskQueueOverhead{0};
-    static constexpr std::chrono::time_point<std::chrono::high_resolution_clock> tinit = std::chrono::time_point<std::chrono::high_resolution_clock>::max();
 
     TaskingProfiler(const TaskingProfiler& copy) = delete;
     TaskingProfiler& operator=(const TaskingProfiler& src) = delete;
 
+    /**
+     * Task that is currently executed by a core.
+     */
+    struct alignas(64) running_task
+    {
+        std::uint64_t id;
+        std::uint64_t start;
+        const char* name;
+        std::uint32_t type;
+
+        // tasks to skip until the next task is sampled
+        std::uint32_t countdown;
+
+        // timestamp of the last sampled task
+        std::uint64_t last_sample;
+
+        // ticks spent for profiling tasks of the core
+        std::uint64_t overhead;
+    };
+
+    /**
+     * Durations of recorded tasks of a type, aggregated by the drainer.
+     */
+    struct task_type_aggregate
+    {
+        std::uint64_t count{0};
+        std::uint64_t total{0};
+        std::uint64_t min{std::numeric_limits<std::uint64_t>::max()};
+        std::uint64_t max{0};
+        mx::tasking::profiling::LatencyHistogram histogram;
+    };
+
     // total number of cores
-    std::uint16_t total_cores;
+    std::uint16_t total_cores{0U};
+
+    // bounded lock-free buffer of records for every core
+    std::vector<std::unique_ptr<mx::util::BoundMPMCQueue<record>>> buffers;
+
+    // task that is currently executed for every core
+    std::unique_ptr<running_task[]> running_tasks;
+
+    // binary trace the records are streamed to
+    mx::tasking::profiling::trace::Writer trace;
+    std::string trace_file;
+
+    // ids of task names already written to the trace
+    std::unordered_map<const char*, std::uint64_t> names;
 
-    // profile data inside a multidimensional array
-    task_info** task_data;
-    queue_info** queue_data;
+    // last timestamp written to the trace for every core
+    std::vector<std::uint64_t> last_timestamp;
 
-    // id counters for every core
-    std::uint64_t* task_id_counter;
-    std::uint64_t* queue_id_counter;
+    // number of task records written to the trace for every core
+    std::vector<std::uint64_t> task_counter;
+
+    // thread streaming the buffers to disk
+    std::thread drainer;
+    std::atomic<bool> is_draining{false};
+
+    // records that were dropped because the buffer of the core was full
+    std::atomic<std::uint64_t> dropped{0};
+
+    // every n-th task of a core is sampled
+    std::atomic<std::uint32_t> sample_every{1};
+
+    // minimal ticks between two sampled tasks of a core
+    std::atomic<std::uint64_t> sample_interval{0};
+
+    // aggregated durations of every task type
+    std::unordered_map<const char*, task_type_aggregate> task_types;
+    mutable std::mutex task_types_latch;
+
+    /**
+     * @brief Pushes a record to the buffer of a core; the record is dropped when the buffer is full.
+     *
+     * @param cpu_core core the record belongs to
+     * @param rec record to push
+     */
+    void push(std::uint16_t cpu_core, const record& rec);
+
+    /**
+     * @brief Moves all buffered records to the trace.
+     *
+     * @return number of drained records
+     */
+    std::uint64_t drain();
+
+    /**
+     * @brief Stops the drainer thread after draining all records.
+     */
+    void stopDrainer();
+
+    /**
+     * @return current timestamp of the time stamp counter
+     */
+    static std::uint64_t now() { return mx::system::tsc::read(); }
+
+    /**
+     * @param timestamp timestamp of the time stamp counter
+     * @return nanoseconds since the initialization of the profiler
+     */
+    std::uint64_t toNanoseconds(std::uint64_t timestamp) const;
 
 public:
     /**
-     * @brief 
-     * 
-     * @param corenum 
+     * @brief Allocates the buffers and starts the drainer thread, streaming the records
+     * of every core to a binary trace; see mxtrace to convert it into a Chrome trace.
+     *
+     * @param corenum highest core id to profile
+     * @param trace_file_name file the trace is written to
      */
-    void init(std::uint16_t corenum);
+    void init(std::uint16_t corenum, std::string trace_file_name = "tasking_profile.mxtrace");
 
     /**
-     * @brief 
-     * 
-     * @param type 
-     * @return std::uint64_t 
+     * @brief Records only a sample of the tasks of every core; may be changed while tasks are executed.
+     * Enqueue events are not recorded while sampling, since queue lengths cannot be derived from samples.
+     *
+     * @param every_nth_task every n-th task of a core is recorded (1 records every task)
+     * @param interval_ns minimal nanoseconds between two recorded tasks of a core (0 for no limit)
+     */
+    void sample(std::uint32_t every_nth_task, std::uint64_t interval_ns = 0);
+
+    /**
+     * @return true, if only a sample of the tasks is recorded
+     */
+    bool isSampling() const
+    {
+        return sample_every.load(std::memory_order_relaxed) > 1 || sample_interval.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @return durations of the recorded tasks of every type, ordered by their total duration
+     */
+    std::vector<task_type_profile> taskTypes() const;
+
+    /**
+     * @brief Marks the start of a task on the given core.
+     *
+     * @param cpu_core core executing the task
+     * @param type type of the task
+     * @param name name of the task
+     * @return id of the task on the core; zero, if the task is not sampled
      */
     std::uint64_t startTask(std::uint16_t cpu_core, std::uint32_t type, const char* name);
     
     /**
-     * @brief 
-     * 
-     * @param id 
+     * @brief Marks the end of the task started last on the given core.
+     *
+     * @param cpu_core core executing the task
+     * @param id id returned by startTask()
      */
     void endTask(std::uint16_t cpu_core, std::uint64_t id);
 
     /**
-     * @brief 
-     * 
-     * @param corenum
+     * @brief Records a task enqueued for the given core; may be called by any thread.
+     *
+     * @param corenum core the task is enqueued for
      */
     void enqueue(std::uint16_t corenum);
 
     /**
-     * @brief 
-     * 
-     * @param file 
+     * @brief Writes the remaining records, closes the trace and prints a summary and the durations
+     * of every task type to stdout.
      */
     void saveProfile();
-
-    /**
-     * @brief 
-     * 
-     * @param start 
-     * @param end 
-     */
-    void printTP(std::uint64_t start, std::uint64_t end);
 };
\ No newline at end of file
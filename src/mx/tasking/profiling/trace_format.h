@@ -0,0 +1,278 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace mx::tasking::profiling::trace {
+/**
+ * Binary trace written by the TaskingProfiler. The trace starts with the
+ * magic, the version and the number of cores, followed by events. Every
+ * event starts with its tag; all integers are stored as varints and
+ * timestamps as (zigzag encoded) deltas to the last timestamp of the core:
+ *
+ *      Name:       id, length, characters      (interned name of a task type)
+ *      Task:       core, name id, type, start delta, duration
+ *      Enqueue:    core, timestamp delta
+ *
+ * Timestamps are nanoseconds relative to the start of the profiler.
+ */
+static constexpr auto magic = std::string_view{"MXTRACE", 8U};
+static constexpr auto version = std::uint64_t{1U};
+
+enum Tag : std::uint8_t
+{
+    Name = 1U,
+    Task = 2U,
+    Enqueue = 3U
+};
+
+[[nodiscard]] inline std::uint64_t zigzag_encode(const std::int64_t value) noexcept
+{
+    return (std::uint64_t(value) << 1U) ^ std::uint64_t(value >> 63U);
+}
+
+[[nodiscard]] inline std::int64_t zigzag_decode(const std::uint64_t value) noexcept
+{
+    return std::int64_t(value >> 1U) ^ -std::int64_t(value & 1U);
+}
+
+/**
+ * Writes the trace through a buffer using write(); not thread safe.
+ */
+class Writer
+{
+public:
+    Writer() noexcept = default;
+    ~Writer() noexcept { close(); }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    /**
+     * Creates (or truncates) the trace file and writes the header.
+     *
+     * @param file_name Name of the trace file.
+     * @param count_cores Number of cores in the trace.
+     * @return True, when the file was opened.
+     */
+    bool open(const std::string &file_name, const std::uint16_t count_cores) noexcept
+    {
+        close();
+        _file_descriptor = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_file_descriptor < 0)
+        {
+            return false;
+        }
+
+        write(magic.data(), magic.size());
+        write_varint(version);
+        write_varint(count_cores);
+        return true;
+    }
+
+    /**
+     * Flushes the buffer and closes the file.
+     */
+    void close() noexcept
+    {
+        if (_file_descriptor >= 0)
+        {
+            flush();
+            ::close(_file_descriptor);
+            _file_descriptor = -1;
+        }
+    }
+
+    [[nodiscard]] bool is_open() const noexcept { return _file_descriptor >= 0; }
+
+    void write_tag(const Tag tag) noexcept { write_byte(std::uint8_t(tag)); }
+
+    void write_varint(std::uint64_t value) noexcept
+    {
+        while (value >= 0x80U)
+        {
+            write_byte(std::uint8_t(value | 0x80U));
+            value >>= 7U;
+        }
+        write_byte(std::uint8_t(value));
+    }
+
+    void write(const char *data, const std::size_t size) noexcept
+    {
+        for (auto i = 0U; i < size; ++i)
+        {
+            write_byte(std::uint8_t(data[i]));
+        }
+    }
+
+    /**
+     * Writes the buffer to the file.
+     */
+    void flush() noexcept
+    {
+        auto written = std::size_t{0U};
+        while (written < _size)
+        {
+            const auto result = ::write(_file_descriptor, _buffer.data() + written, _size - written);
+            if (result <= 0)
+            {
+                break;
+            }
+            written += std::size_t(result);
+        }
+        _size = 0U;
+    }
+
+private:
+    std::int32_t _file_descriptor{-1};
+    std::size_t _size{0U};
+    std::array<std::uint8_t, 1U << 16U> _buffer;
+
+    void write_byte(const std::uint8_t byte) noexcept
+    {
+        if (_size == _buffer.size())
+        {
+            flush();
+        }
+        _buffer[_size++] = byte;
+    }
+};
+
+/**
+ * Reads a trace through a buffer using read().
+ */
+class Reader
+{
+public:
+    Reader() noexcept = default;
+    ~Reader() noexcept
+    {
+        if (_file_descriptor >= 0)
+        {
+            ::close(_file_descriptor);
+        }
+    }
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /**
+     * Opens the trace file and reads the header.
+     *
+     * @param file_name Name of the trace file.
+     * @return True, when the file is a trace of a supported version.
+     */
+    bool open(const std::string &file_name) noexcept
+    {
+        _file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+        if (_file_descriptor < 0)
+        {
+            return false;
+        }
+
+        auto header = std::array<char, magic.size()>{};
+        for (auto &character : header)
+        {
+            auto byte = std::uint8_t{0U};
+            if (read_byte(byte) == false)
+            {
+                return false;
+            }
+            character = char(byte);
+        }
+
+        auto trace_version = std::uint64_t{0U};
+        auto count_cores = std::uint64_t{0U};
+        if (std::string_view{header.data(), header.size()} != magic || read_varint(trace_version) == false ||
+            trace_version != version || read_varint(count_cores) == false)
+        {
+            return false;
+        }
+
+        _count_cores = std::uint16_t(count_cores);
+        return true;
+    }
+
+    [[nodiscard]] std::uint16_t count_cores() const noexcept { return _count_cores; }
+
+    /**
+     * @param tag Tag of the next event.
+     * @return False at the end of the trace.
+     */
+    bool read_tag(Tag &tag) noexcept
+    {
+        auto byte = std::uint8_t{0U};
+        if (read_byte(byte))
+        {
+            tag = Tag(byte);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool read_varint(std::uint64_t &value) noexcept
+    {
+        value = 0U;
+        auto byte = std::uint8_t{0U};
+        for (auto shift = 0U; shift < 64U; shift += 7U)
+        {
+            if (read_byte(byte) == false)
+            {
+                return false;
+            }
+            value |= std::uint64_t(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0U)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool read(std::string &data, const std::size_t size) noexcept
+    {
+        data.resize(size);
+        auto byte = std::uint8_t{0U};
+        for (auto i = 0U; i < size; ++i)
+        {
+            if (read_byte(byte) == false)
+            {
+                return false;
+            }
+            data[i] = char(byte);
+        }
+
+        return true;
+    }
+
+private:
+    std::int32_t _file_descriptor{-1};
+    std::uint16_t _count_cores{0U};
+    std::size_t _position{0U};
+    std::size_t _size{0U};
+    std::array<std::uint8_t, 1U << 16U> _buffer;
+
+    bool read_byte(std::uint8_t &byte) noexcept
+    {
+        if (_position == _size)
+        {
+            const auto result = ::read(_file_descriptor, _buffer.data(), _buffer.size());
+            if (result <= 0)
+            {
+                return false;
+            }
+            _position = 0U;
+            _size = std::size_t(result);
+        }
+
+        byte = _buffer[_position++];
+        return true;
+    }
+};
+} // namespace mx::tasking::profiling::trace
\ No newline at end of file
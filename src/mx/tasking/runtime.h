@@ -1,4 +1,6 @@
 #pragma once
+#include "coroutine.h"
+#include "parallel.h"
 #include "scheduler.h"
 #include "task.h"
 #include <iostream>
@@ -9,6 +11,7 @@
 #include <mx/resource/builder.h>
 #include <mx/util/core_set.h>
 #include <utility>
+#include <vector>
 
 #include "profiling/tasking_profiler.h"
 
@@ -67,6 +70,22 @@ public:
                                       memory::fixed::Allocator<config::task_size()>(core_set));
         }
 
+        // Create a new allocator for coroutine frames.
+        if (use_system_allocator)
+        {
+            _coroutine_frame_allocator.reset(
+                new (memory::GlobalHeap::allocate_cache_line_aligned(
+                    sizeof(memory::SystemTaskAllocator<config::coroutine_frame_size()>)))
+                    memory::SystemTaskAllocator<config::coroutine_frame_size()>());
+        }
+        else
+        {
+            _coroutine_frame_allocator.reset(
+                new (memory::GlobalHeap::allocate_cache_line_aligned(
+                    sizeof(memory::fixed::Allocator<config::coroutine_frame_size()>)))
+                    memory::fixed::Allocator<config::coroutine_frame_size()>(core_set));
+        }
+
         // Create a new scheduler.
         const auto need_new_scheduler = _scheduler == nullptr || *_scheduler != core_set;
         if (need_new_scheduler)
@@ -113,6 +132,39 @@ public:
      */
     static void spawn(TaskInterface &task) noexcept { _scheduler->schedule(task); }
 
+    /**
+     * Spawns the given task as part of a batch: Tasks for remote channels are
+     * collected per channel and published together after the currently
+     * executed task finished. Must be called from within a task.
+     * @param task Task to be scheduled.
+     * @param current_channel_id Channel, the spawn request came from.
+     */
+    static void spawn_batch(TaskInterface &task, const std::uint16_t current_channel_id) noexcept
+    {
+        _scheduler->schedule_batched(task, current_channel_id);
+    }
+
+    /**
+     * Spawns a task without annotation, such that idle channels can steal it
+     * before the current channel executes it. Must be called from within a task.
+     * @param task Task to be scheduled.
+     * @param current_channel_id Channel, the spawn request came from.
+     */
+    static void spawn_stealable(TaskInterface &task, const std::uint16_t current_channel_id) noexcept
+    {
+        _scheduler->schedule_stealable(task, current_channel_id);
+    }
+
+    /**
+     * Publishes all tasks spawned by spawn_batch() from the given channel so far.
+     * This is done automatically after every executed task.
+     * @param current_channel_id Channel, the spawn requests came from.
+     */
+    static void flush_spawn_batch(const std::uint16_t current_channel_id) noexcept
+    {
+        _scheduler->flush(current_channel_id);
+    }
+
     /**
      * @return Number of available channels.
      */
@@ -130,6 +182,49 @@ public:
      */
     static void stop() noexcept { _scheduler->interrupt(); }
 
+    /**
+     * Calls the function for every index of [begin, end) in parallel. The range is
+     * distributed over all channels; every channel splits its chunk recursively
+     * until chunks fit the grain. Split chunks can be stolen by idle channels.
+     *
+     * @param core_id Core to allocate the tasks from.
+     * @param begin First index of the range.
+     * @param end Index behind the last index of the range.
+     * @param grain Maximal number of indices processed by one task.
+     * @param function Function called with every index.
+     * @param callback Function called (within a task) after all indices are processed.
+     */
+    template <typename F, typename C>
+    static void parallel_for(const std::uint16_t core_id, const std::uint64_t begin, const std::uint64_t end,
+                             const std::uint64_t grain, F &&function, C &&callback)
+    {
+        auto *context = new ParallelForContext<F, C>(grain, std::forward<F>(function), std::forward<C>(callback));
+        runtime::dispatch_parallel(core_id, begin, end, context);
+    }
+
+    /**
+     * Maps every index of [begin, end) to a value and reduces all values in parallel,
+     * distributed like parallel_for(). The reduce function has to be associative.
+     *
+     * @param core_id Core to allocate the tasks from.
+     * @param begin First index of the range.
+     * @param end Index behind the last index of the range.
+     * @param grain Maximal number of indices processed by one task.
+     * @param identity Neutral element of the reduce function.
+     * @param map Function mapping an index to a value.
+     * @param reduce Function combining two values.
+     * @param callback Function called (within a task) with the reduced value.
+     */
+    template <typename T, typename M, typename R, typename C>
+    static void parallel_reduce(const std::uint16_t core_id, const std::uint64_t begin, const std::uint64_t end,
+                                const std::uint64_t grain, const T &identity, M &&map, R &&reduce, C &&callback)
+    {
+        auto *context = new ParallelReduceContext<T, M, R, C>(grain, runtime::channels(), identity,
+                                                              std::forward<M>(map), std::forward<R>(reduce),
+                                                              std::forward<C>(callback));
+        runtime::dispatch_parallel(core_id, begin, end, context);
+    }
+
     /**
      * Creates a new task.
      * @param core_id Core to allocate memory from.
@@ -153,12 +248,59 @@ public:
         _task_allocator->free(core_id, static_cast<void *>(task));
     }
 
+    /**
+     * Allocates the frame of a coroutine.
+     * @param core_id Core to allocate memory for.
+     * @param size Size of the frame.
+     * @return Allocated memory.
+     */
+    static void *new_coroutine_frame(const std::uint16_t core_id, const std::size_t size)
+    {
+        if (size <= config::coroutine_frame_size())
+        {
+            return _coroutine_frame_allocator->allocate(core_id);
+        }
+
+        return ::operator new(size);
+    }
+
+    /**
+     * Frees the frame of a coroutine.
+     * @param core_id Core id to return the memory to.
+     * @param frame Frame to be freed.
+     * @param size Size of the frame.
+     */
+    static void delete_coroutine_frame(const std::uint16_t core_id, void *frame, const std::size_t size) noexcept
+    {
+        if (size <= config::coroutine_frame_size())
+        {
+            _coroutine_frame_allocator->free(core_id, frame);
+        }
+        else
+        {
+            ::operator delete(frame, size);
+        }
+    }
+
+    /**
+     * Prefetches the given resource and suspends the calling coroutine
+     * until the worker executed some other tasks.
+     * Usage: co_await runtime::prefetch(resource, size);
+     * @param resource Resource to prefetch.
+     * @param size Number of bytes to prefetch.
+     * @return Awaitable for coroutines.
+     */
+    static PrefetchAwaiter prefetch(const resource::ptr resource, const std::uint16_t size) noexcept
+    {
+        return PrefetchAwaiter{resource.get(), size};
+    }
+
     /**
      * Creates a resource.
      * @param size Size of the data object.
      * @param hint Hints for allocation and scheduling.
      * @param arguments Arguments for the data object.
-     * @return The resource pointer.
+     * @return The resource pointer; nullptr, if the memory limit of the NUMA region is reached.
      */
     template <typename T, typename... Args>
     static resource::ptr new_resource(const std::size_t size, resource::hint &&hint, Args &&... arguments) noexcept
@@ -193,6 +335,53 @@ public:
 
     static void free(void *pointer) noexcept { _resource_allocator->free(pointer); }
 
+    /**
+     * Limits the memory taken from the OS on a NUMA region. Beyond the soft limit, free
+     * memory of the resource allocator is reused before new memory is taken; beyond the
+     * hard limit, resources can not be allocated (nullptr is returned). Unused memory is
+     * given back when the runtime is initialized again.
+     * @param numa_node_id NUMA region.
+     * @param limit Soft and hard limit in bytes; zero means no limit.
+     */
+    static void memory_limit(const std::uint8_t numa_node_id, const memory::MemoryLimit limit) noexcept
+    {
+        memory::GlobalHeap::limit(numa_node_id, limit);
+    }
+
+    /**
+     * Reads the memory held by the task, coroutine frame, and resource allocators
+     * on every NUMA region; can be polled by any thread.
+     * @return Memory usage of every NUMA region; empty, when the runtime is not initialized.
+     */
+    static std::vector<memory::NumaMemoryUsage> memory_usage()
+    {
+        if (_resource_allocator == nullptr || _task_allocator == nullptr)
+        {
+            return {};
+        }
+
+        auto usage = std::vector<memory::NumaMemoryUsage>{};
+        for (auto numa_node_id = std::uint8_t(0U); numa_node_id <= system::topology::max_node_id(); ++numa_node_id)
+        {
+            auto &numa_usage = usage.emplace_back();
+            numa_usage.numa_node_id = numa_node_id;
+            numa_usage.global_heap = memory::GlobalHeap::reserved(numa_node_id);
+            numa_usage.limit = memory::GlobalHeap::limit(numa_node_id);
+            numa_usage.refused_allocations = _resource_allocator->count_refused_allocations(numa_node_id);
+            numa_usage.tasks = _task_allocator->usage(numa_node_id);
+            numa_usage.tasks += _coroutine_frame_allocator->usage(numa_node_id);
+            numa_usage.cross_node_task_frees = _task_allocator->count_cross_node_frees(numa_node_id) +
+                                               _coroutine_frame_allocator->count_cross_node_frees(numa_node_id);
+            numa_usage.allocation_blocks = _resource_allocator->usage(numa_node_id);
+            for (auto size_class = std::uint8_t(0U); size_class < memory::config::count_size_classes(); ++size_class)
+            {
+                numa_usage.size_classes[size_class] = _resource_allocator->usage(numa_node_id, size_class);
+            }
+        }
+
+        return usage;
+    }
+
     /**
      * Updates the prediction of a data object.
      * @param resource Data object, whose usage should be predicted.
@@ -237,6 +426,56 @@ public:
         return _scheduler->statistic(counter, channel_id);
     }
 
+    /**
+     * Registers a named counter (e.g., splits of a tree) at startup; registering
+     * a name twice returns the same counter. Counters are reset with the statistics.
+     * @param name Name of the counter.
+     * @return Id of the counter.
+     */
+    static profiling::CounterRegistry::counter_id_t register_counter(std::string name)
+    {
+        return _scheduler->register_counter(std::move(name));
+    }
+
+    /**
+     * Adds a value to a registered counter, when statistics are enabled.
+     * Only the worker of the given channel may call (e.g., from a task).
+     * @param channel_id Channel executing the calling task.
+     * @param counter_id Id of the counter.
+     * @param value Value to add.
+     */
+    static void count(const std::uint16_t channel_id, const profiling::CounterRegistry::counter_id_t counter_id,
+                      const std::uint64_t value = 1U) noexcept
+    {
+        _scheduler->count(channel_id, counter_id, value);
+    }
+
+    /**
+     * @return Registry of the built-in and registered counters, e.g., to read counters by name.
+     */
+    static const profiling::CounterRegistry &counters() noexcept { return _scheduler->counters(); }
+
+    /**
+     * Reads the queueing and execution latencies of every task type, merged over all channels.
+     * @return Latencies per task type.
+     */
+    static std::vector<profiling::TaskLatency> statistic() { return _scheduler->statistic(); }
+
+    /**
+     * Reads queue depth, executed and stolen tasks, fills, idle ratio, and task latency
+     * of every channel. The metrics are always recorded and can be polled by any thread.
+     * @return Snapshot of every channel; empty, when the runtime is not initialized.
+     */
+    static std::vector<profiling::ChannelSnapshot> snapshot()
+    {
+        if (_scheduler == nullptr)
+        {
+            return {};
+        }
+
+        return _scheduler->snapshot();
+    }
+
 private:
     // Scheduler to spawn tasks.
     inline static std::unique_ptr<Scheduler> _scheduler = {nullptr};
@@ -244,11 +483,45 @@ private:
     // Allocator to allocate tasks (could be systems malloc or our Multi-level allocator).
     inline static std::unique_ptr<memory::TaskAllocatorInterface> _task_allocator = {nullptr};
 
+    // Allocator to allocate frames of coroutines.
+    inline static std::unique_ptr<memory::TaskAllocatorInterface> _coroutine_frame_allocator = {nullptr};
+
     // Allocator to allocate resources.
     inline static std::unique_ptr<memory::dynamic::Allocator> _resource_allocator = {nullptr};
 
     // Allocator to allocate data objects.
     inline static std::unique_ptr<resource::Builder> _resource_builder = {nullptr};
+
+    /**
+     * Distributes the range of a parallel_for/parallel_reduce as one chunk
+     * per channel; the context is freed after all chunks are done.
+     *
+     * @param core_id Core to allocate the tasks from.
+     * @param begin First index of the range.
+     * @param end Index behind the last index of the range.
+     * @param context Context of the parallel_for/parallel_reduce.
+     */
+    static void dispatch_parallel(const std::uint16_t core_id, const std::uint64_t begin, const std::uint64_t end,
+                                  ParallelContextInterface *context)
+    {
+        const auto count_channels = runtime::channels();
+        auto *finish_task = runtime::new_task<ParallelFinishTask>(core_id, context);
+        context->join_counter().reset(count_channels, finish_task);
+
+        const auto count = end > begin ? end - begin : 0U;
+        const auto count_per_channel = count / count_channels;
+        const auto remainder = count % count_channels;
+
+        auto chunk_begin = begin;
+        for (auto channel_id = std::uint16_t(0U); channel_id < count_channels; ++channel_id)
+        {
+            const auto chunk_end = chunk_begin + count_per_channel + (channel_id < remainder ? 1U : 0U);
+            auto *chunk_task = runtime::new_task<ParallelChunkTask>(core_id, *context, chunk_begin, chunk_end);
+            chunk_task->annotate(channel_id);
+            runtime::spawn(*chunk_task);
+            chunk_begin = chunk_end;
+        }
+    }
 };
 
 /**
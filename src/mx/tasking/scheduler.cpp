@@ -4,7 +4,9 @@
 #include <mx/synchronization/synchronization.h>
 #include <mx/system/thread.h>
 #include <mx/system/topology.h>
+#include <mx/system/tsc.h>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using namespace mx::tasking;
@@ -21,12 +23,35 @@ Scheduler::Scheduler(const mx::util::core_set &core_set, const std::uint16_t pre
     {
         const auto core_id = this->_core_set[worker_id];
         this->_channel_numa_node_map[worker_id] = system::topology::node_id(core_id);
+        const auto numa_node_id = this->_channel_numa_node_map[worker_id];
+        this->_numa_node_channels[numa_node_id][this->_count_numa_node_channels[numa_node_id]++] = worker_id;
         this->_worker[worker_id] =
             new (memory::GlobalHeap::allocate(this->_channel_numa_node_map[worker_id], sizeof(Worker)))
                 Worker(worker_id, core_id, this->_channel_numa_node_map[worker_id], this->_is_running,
                        prefetch_distance, this->_epoch_manager[worker_id], this->_epoch_manager.global_epoch(),
                        this->_statistic);
     }
+
+    // Every worker visits the channels of its own NUMA region first, starting with
+    // its neighbour to spread thieves over different victims.
+    if constexpr (config::work_stealing())
+    {
+        for (auto worker_id = 0U; worker_id < this->_count_channels; ++worker_id)
+        {
+            const auto numa_node_id = this->_channel_numa_node_map[worker_id];
+            for (const auto is_numa_local : {true, false})
+            {
+                for (auto i = 1U; i < this->_count_channels; ++i)
+                {
+                    const auto victim_id = (worker_id + i) % this->_count_channels;
+                    if ((this->_channel_numa_node_map[victim_id] == numa_node_id) == is_numa_local)
+                    {
+                        this->_worker[worker_id]->add_steal_victim(this->_worker[victim_id]->channel());
+                    }
+                }
+            }
+        }
+    }
 }
 
 Scheduler::~Scheduler() noexcept
@@ -34,10 +59,17 @@ Scheduler::~Scheduler() noexcept
     if constexpr (config::use_tasking_profiler()){
         TaskingProfiler::getInstance().saveProfile();
     }
-    for (auto *worker : this->_worker)
+    for (auto worker_id = 0U; worker_id < this->_worker.size(); ++worker_id)
     {
+        // Slots beyond the number of channels hold no worker.
+        auto *worker = this->_worker[worker_id];
+        if (worker == nullptr)
+        {
+            continue;
+        }
+
         worker->~Worker();
-        memory::GlobalHeap::free(worker, sizeof(Worker));
+        memory::GlobalHeap::free(worker, sizeof(Worker), this->_channel_numa_node_map[worker_id]);
     }
 }
 
@@ -83,6 +115,11 @@ void Scheduler::start_and_wait()
 
 void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channel_id) noexcept
 {
+    if (config::task_queueing_statistics() && diagnostics::is_statistics_enabled())
+    {
+        task.spawned(system::tsc::read());
+    }
+
     // Scheduling is based on the annotated resource of the given task.
     if (task.has_resource_annotated())
     {
@@ -95,10 +132,10 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
                                        resource_channel_id, current_channel_id))
         {
             this->_worker[current_channel_id]->channel().push_back_local(&task);
-            if constexpr (config::use_tasking_profiler()){
+            if (diagnostics::is_task_queue_length_enabled()){
                 TaskingProfiler::getInstance().enqueue(current_channel_id);
             }
-            if constexpr (config::task_statistics())
+            if (diagnostics::is_statistics_enabled())
             {
                 this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
             }
@@ -107,10 +144,10 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
         {
             this->_worker[resource_channel_id]->channel().push_back_remote(&task,
                                                                            this->numa_node_id(current_channel_id));
-            if constexpr (config::use_tasking_profiler()){
+            if (diagnostics::is_task_queue_length_enabled()){
                 TaskingProfiler::getInstance().enqueue(resource_channel_id);
             }
-            if constexpr (config::task_statistics())
+            if (diagnostics::is_statistics_enabled())
             {
                 this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(current_channel_id);
             }
@@ -127,10 +164,10 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
         if (target_channel_id == current_channel_id)
         {
             this->_worker[current_channel_id]->channel().push_back_local(&task);
-            if constexpr (config::use_tasking_profiler()){
+            if (diagnostics::is_task_queue_length_enabled()){
                 TaskingProfiler::getInstance().enqueue(current_channel_id);
             }
-            if constexpr (config::task_statistics())
+            if (diagnostics::is_statistics_enabled())
             {
                 this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
             }
@@ -138,10 +175,10 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
         else
         {
             this->_worker[target_channel_id]->channel().push_back_remote(&task, this->numa_node_id(current_channel_id));
-            if constexpr (config::use_tasking_profiler()){
+            if (diagnostics::is_task_queue_length_enabled()){
                 TaskingProfiler::getInstance().enqueue(target_channel_id); 
             }
-            if constexpr (config::task_statistics())
+            if (diagnostics::is_statistics_enabled())
             {
                 this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(current_channel_id);
             }
@@ -151,24 +188,48 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
     // The developer assigned a fixed NUMA region to the task.
     else if (task.has_node_annotated())
     {
-        // TODO: Select random channel @ node, based on load
-        assert(false && "NOT IMPLEMENTED: Task scheduling for node.");
+        const auto target_channel_id = this->least_loaded_channel(task.annotated_node());
+
+        // For performance reasons, we prefer the local (not synchronized) queue
+        // whenever possible to spawn the task.
+        if (target_channel_id == current_channel_id)
+        {
+            this->_worker[current_channel_id]->channel().push_back_local(&task);
+            if (diagnostics::is_task_queue_length_enabled()){
+                TaskingProfiler::getInstance().enqueue(current_channel_id);
+            }
+            if (diagnostics::is_statistics_enabled())
+            {
+                this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
+            }
+        }
+        else
+        {
+            this->_worker[target_channel_id]->channel().push_back_remote(&task, this->numa_node_id(current_channel_id));
+            if (diagnostics::is_task_queue_length_enabled()){
+                TaskingProfiler::getInstance().enqueue(target_channel_id);
+            }
+            if (diagnostics::is_statistics_enabled())
+            {
+                this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(current_channel_id);
+            }
+        }
     }
 
     // The task can run everywhere.
     else
     {
         this->_worker[current_channel_id]->channel().push_back_local(&task);
-        if constexpr (config::use_tasking_profiler()){
+        if (diagnostics::is_task_queue_length_enabled()){
             TaskingProfiler::getInstance().enqueue(current_channel_id);
         }
-        if constexpr (config::task_statistics())
+        if (diagnostics::is_statistics_enabled())
         {
             this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
         }
     }
 
-    if constexpr (config::task_statistics())
+    if (diagnostics::is_statistics_enabled())
     {
         this->_statistic.increment<profiling::Statistic::Scheduled>(current_channel_id);
     }
@@ -176,33 +237,45 @@ void Scheduler::schedule(TaskInterface &task, const std::uint16_t current_channe
 
 void Scheduler::schedule(TaskInterface &task) noexcept
 {
+    if (config::task_queueing_statistics() && diagnostics::is_statistics_enabled())
+    {
+        task.spawned(system::tsc::read());
+    }
+
     if (task.has_resource_annotated())
     {
         const auto &annotated_resource = task.annotated_resource();
         this->_worker[annotated_resource.channel_id()]->channel().push_back_remote(&task, 0U);
-        if constexpr (config::use_tasking_profiler()){
+        if (diagnostics::is_task_queue_length_enabled()){
             TaskingProfiler::getInstance().enqueue(annotated_resource.channel_id());
         }
-        if constexpr (config::task_statistics())
+        if (diagnostics::is_statistics_enabled())
         {
-            this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(annotated_resource.channel_id());
+            this->_statistic.increment_shared<profiling::Statistic::ScheduledOffChannel>();
         }
     }
     else if (task.has_channel_annotated())
     {
         this->_worker[task.annotated_channel()]->channel().push_back_remote(&task, 0U);
-        if constexpr (config::use_tasking_profiler()){
+        if (diagnostics::is_task_queue_length_enabled()){
             TaskingProfiler::getInstance().enqueue(task.annotated_channel());    
         }
-        if constexpr (config::task_statistics())
+        if (diagnostics::is_statistics_enabled())
         {
-            this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(task.annotated_channel());
+            this->_statistic.increment_shared<profiling::Statistic::ScheduledOffChannel>();
         }
     }
     else if (task.has_node_annotated())
     {
-        // TODO: Select random channel @ node, based on load
-        assert(false && "NOT IMPLEMENTED: Task scheduling for node.");
+        const auto target_channel_id = this->least_loaded_channel(task.annotated_node());
+        this->_worker[target_channel_id]->channel().push_back_remote(&task, 0U);
+        if (diagnostics::is_task_queue_length_enabled()){
+            TaskingProfiler::getInstance().enqueue(target_channel_id);
+        }
+        if (diagnostics::is_statistics_enabled())
+        {
+            this->_statistic.increment_shared<profiling::Statistic::ScheduledOffChannel>();
+        }
     }
     else
     {
@@ -210,17 +283,162 @@ void Scheduler::schedule(TaskInterface &task) noexcept
     }
 }
 
+void Scheduler::schedule_batched(TaskInterface &task, const std::uint16_t current_channel_id) noexcept
+{
+    if (config::task_queueing_statistics() && diagnostics::is_statistics_enabled())
+    {
+        task.spawned(system::tsc::read());
+    }
+
+    // Choose the target channel like schedule().
+    auto target_channel_id = current_channel_id;
+    if (task.has_resource_annotated())
+    {
+        const auto annotated_resource = task.annotated_resource();
+        if (Scheduler::keep_task_local(task.is_readonly(), annotated_resource.synchronization_primitive(),
+                                       annotated_resource.channel_id(), current_channel_id) == false)
+        {
+            target_channel_id = annotated_resource.channel_id();
+        }
+    }
+    else if (task.has_channel_annotated())
+    {
+        target_channel_id = task.annotated_channel();
+    }
+    else if (task.has_node_annotated())
+    {
+        target_channel_id = this->least_loaded_channel(task.annotated_node());
+    }
+
+    if (target_channel_id == current_channel_id)
+    {
+        this->_worker[current_channel_id]->channel().push_back_local(&task);
+        if (diagnostics::is_task_queue_length_enabled()){
+            TaskingProfiler::getInstance().enqueue(current_channel_id);
+        }
+        if (diagnostics::is_statistics_enabled())
+        {
+            this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
+        }
+    }
+    else
+    {
+        // Remote tasks are staged and published together.
+        this->_worker[current_channel_id]->spawn_buffer().push_back(target_channel_id, &task);
+        if (diagnostics::is_task_queue_length_enabled()){
+            TaskingProfiler::getInstance().enqueue(target_channel_id);
+        }
+        if (diagnostics::is_statistics_enabled())
+        {
+            this->_statistic.increment<profiling::Statistic::ScheduledOffChannel>(current_channel_id);
+        }
+    }
+
+    if (diagnostics::is_statistics_enabled())
+    {
+        this->_statistic.increment<profiling::Statistic::Scheduled>(current_channel_id);
+    }
+}
+
+void Scheduler::schedule_stealable(TaskInterface &task, const std::uint16_t current_channel_id) noexcept
+{
+    assert(task.has_resource_annotated() == false && task.has_channel_annotated() == false &&
+           task.has_node_annotated() == false && "Stealable tasks may not be annotated.");
+
+    if (config::task_queueing_statistics() && diagnostics::is_statistics_enabled())
+    {
+        task.spawned(system::tsc::read());
+    }
+
+    this->_worker[current_channel_id]->channel().push_back_remote(&task, this->numa_node_id(current_channel_id));
+    if (diagnostics::is_task_queue_length_enabled()){
+        TaskingProfiler::getInstance().enqueue(current_channel_id);
+    }
+    if (diagnostics::is_statistics_enabled())
+    {
+        this->_statistic.increment<profiling::Statistic::ScheduledOnChannel>(current_channel_id);
+        this->_statistic.increment<profiling::Statistic::Scheduled>(current_channel_id);
+    }
+}
+
+void Scheduler::flush(const std::uint16_t current_channel_id) noexcept
+{
+    const auto numa_node_id = this->numa_node_id(current_channel_id);
+    this->_worker[current_channel_id]->spawn_buffer().flush(
+        [this, numa_node_id](const std::uint16_t target_channel_id, TaskInterface *begin, TaskInterface *end,
+                             const std::uint32_t count) {
+            this->_worker[target_channel_id]->channel().push_back_remote(begin, end, count, numa_node_id);
+        });
+}
+
+std::uint16_t Scheduler::least_loaded_channel(const std::uint8_t numa_node_id) noexcept
+{
+    assert(numa_node_id < memory::config::max_numa_nodes() && "NUMA region exceeds max. NUMA regions.");
+    const auto count_channels = this->_count_numa_node_channels[numa_node_id];
+    if (count_channels == 0U)
+    {
+        return this->least_loaded_channel(this->_channel_numa_node_map[0U]);
+    }
+
+    const auto &channels = this->_numa_node_channels[numa_node_id];
+
+    // Start at another channel every time; tasks spawned in a row will
+    // be spread over all channels when their load is equal.
+    const auto offset = this->_numa_node_channel_offset[numa_node_id].fetch_add(1U, std::memory_order_relaxed);
+
+    // Channels are ranked by the number of waiting tasks; the load (fills of the
+    // task buffer) only breaks ties, since every busy channel reaches the full load.
+    const auto channel_load = [this](const std::uint16_t channel_id) {
+        const auto &channel = this->_worker[channel_id]->channel();
+        return std::make_pair(channel.metrics().queue_depth(), channel.load().count());
+    };
+
+    auto target_channel_id = channels[offset % count_channels];
+    auto target_load = channel_load(target_channel_id);
+    for (auto i = 1U; i < count_channels && target_load != decltype(target_load){0U, 0U}; ++i)
+    {
+        const auto channel_id = channels[(offset + i) % count_channels];
+        const auto load = channel_load(channel_id);
+        if (load < target_load)
+        {
+            target_channel_id = channel_id;
+            target_load = load;
+        }
+    }
+
+    return target_channel_id;
+}
+
 void Scheduler::reset() noexcept
 {
     this->_statistic.clear();
     this->_epoch_manager.reset();
 }
 
+std::vector<profiling::ChannelSnapshot> Scheduler::snapshot() const
+{
+    const auto now = system::tsc::read();
+
+    auto snapshot = std::vector<profiling::ChannelSnapshot>{};
+    snapshot.reserve(this->_count_channels);
+    for (auto channel_id = std::uint16_t(0U); channel_id < this->_count_channels; ++channel_id)
+    {
+        const auto &metrics = this->_worker[channel_id]->channel().metrics();
+        snapshot.emplace_back(profiling::ChannelSnapshot{channel_id, metrics.queue_depth(), metrics.executed(),
+                                                         metrics.stolen(), metrics.fills(), metrics.idle_ratio(now),
+                                                         metrics.idle().count(), metrics.idle_cycles(),
+                                                         metrics.latency().percentile(0.5),
+                                                         metrics.latency().percentile(0.99)});
+    }
+
+    return snapshot;
+}
+
 void Scheduler::profile(const std::string &output_file)
 {
-    this->_profiler.profile(output_file);
-    for (auto i = 0U; i < this->_count_channels; ++i)
+    this->_profiler.profile(output_file, this->_count_channels);
+    for (auto channel_id = std::uint16_t(0U); channel_id < this->_count_channels; ++channel_id)
     {
-        this->_profiler.profile(this->_is_running, this->_worker[i]->channel());
+        this->_worker[channel_id]->log_idle_ranges(this->_profiler.idle_range_log(channel_id));
     }
 }
\ No newline at end of file
@@ -12,11 +12,14 @@
 #include <mx/memory/dynamic_size_allocator.h>
 #include <mx/memory/reclamation/epoch_manager.h>
 #include <mx/resource/resource.h>
-#include <mx/tasking/profiling/profiling_task.h>
+#include <mx/tasking/profiling/idle_profiler.h>
+#include <mx/tasking/profiling/metrics.h>
 #include <mx/tasking/profiling/statistic.h>
 #include <mx/util/core_set.h>
 #include <mx/util/random.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "profiling/tasking_profiler.h"
 
@@ -45,6 +48,29 @@ public:
      */
     void schedule(TaskInterface &task) noexcept;
 
+    /**
+     * Schedules a given task as part of a batch. Tasks for remote channels
+     * are staged by the worker of the current channel and published by flush().
+     * @param task Task to be scheduled.
+     * @param current_channel_id Channel, the request came from.
+     */
+    void schedule_batched(TaskInterface &task, std::uint16_t current_channel_id) noexcept;
+
+    /**
+     * Schedules a task without annotation to the remote queues of the current
+     * channel; other than the local queues, idle channels can steal from there.
+     * @param task Task to be scheduled.
+     * @param current_channel_id Channel, the request came from.
+     */
+    void schedule_stealable(TaskInterface &task, std::uint16_t current_channel_id) noexcept;
+
+    /**
+     * Publishes all tasks staged by schedule_batched() to their channels;
+     * one atomic operation per target channel and priority.
+     * @param current_channel_id Channel, the tasks were staged at.
+     */
+    void flush(std::uint16_t current_channel_id) noexcept;
+
     /**
      * Starts all worker threads and waits until they finish.
      */
@@ -58,7 +84,23 @@ public:
     {
         _is_interrupted = true;
         _is_running = false;
+
+        // Workers stop logging idle ranges before the logs are written.
+        for (auto channel_id = 0U; channel_id < _count_channels; ++channel_id)
+        {
+            _worker[channel_id]->log_idle_ranges(nullptr);
+        }
         this->_profiler.stop();
+
+        // Parked workers have to notice the interruption.
+        if constexpr (config::worker_parking())
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (auto channel_id = 0U; channel_id < _count_channels; ++channel_id)
+            {
+                _worker[channel_id]->channel().wake_up();
+            }
+        }
     }
 
     /**
@@ -164,6 +206,58 @@ public:
         }
     }
 
+    /**
+     * Registers a named counter, applications can increment per channel.
+     * @param name Name of the counter.
+     * @return Id of the counter.
+     */
+    profiling::CounterRegistry::counter_id_t register_counter(std::string name)
+    {
+        return this->_statistic.counters().register_counter(std::move(name));
+    }
+
+    /**
+     * Adds a value to a registered counter of the given channel, when statistics are enabled.
+     * @param channel_id Channel of the calling worker.
+     * @param counter_id Id of the counter.
+     * @param value Value to add.
+     */
+    void count(const std::uint16_t channel_id, const profiling::CounterRegistry::counter_id_t counter_id,
+               const std::uint64_t value) noexcept
+    {
+        if (diagnostics::is_statistics_enabled())
+        {
+            this->_statistic.counters().increment(channel_id, counter_id, value);
+        }
+    }
+
+    /**
+     * @return Registry of the built-in and registered counters.
+     */
+    [[nodiscard]] const profiling::CounterRegistry &counters() const noexcept { return this->_statistic.counters(); }
+
+    /**
+     * Merges the latencies of every task type recorded by all channels.
+     * @return Queueing and execution latencies per task type.
+     */
+    [[nodiscard]] std::vector<profiling::TaskLatency> statistic() const
+    {
+        if constexpr (config::task_statistics())
+        {
+            return this->_statistic.latencies();
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    /**
+     * Reads the metrics of all channels; may be called by any thread while the runtime is running.
+     * @return Snapshot of every channel.
+     */
+    [[nodiscard]] std::vector<profiling::ChannelSnapshot> snapshot() const;
+
     /**
      * Starts profiling of idle times and specifies the results file.
      * @param output_file File to write idle times after stopping MxTasking.
@@ -195,6 +289,16 @@ private:
     // Map of channel id to NUMA region id.
     alignas(64) std::array<std::uint8_t, config::max_cores()> _channel_numa_node_map{0U};
 
+    // Channels of every NUMA region, used to schedule tasks annotated with a NUMA region.
+    alignas(64) std::array<std::array<std::uint16_t, config::max_cores()>, memory::config::max_numa_nodes()>
+        _numa_node_channels{};
+
+    // Number of channels for every NUMA region.
+    std::array<std::uint16_t, memory::config::max_numa_nodes()> _count_numa_node_channels{0U};
+
+    // Offset for choosing a channel within a NUMA region; spreads tasks over equally loaded channels.
+    alignas(64) std::array<std::atomic_uint16_t, memory::config::max_numa_nodes()> _numa_node_channel_offset{};
+
     // Epoch manager for memory reclamation,
     alignas(64) memory::reclamation::EpochManager _epoch_manager;
 
@@ -204,6 +308,15 @@ private:
     // Profiler for idle times.
     profiling::Profiler _profiler{};
 
+    /**
+     * Chooses the channel of the given NUMA region with the fewest waiting tasks.
+     * Regions without any channel fall back to the region of the first channel.
+     *
+     * @param numa_node_id NUMA region.
+     * @return Id of the least loaded channel.
+     */
+    [[nodiscard]] std::uint16_t least_loaded_channel(std::uint8_t numa_node_id) noexcept;
+
     /**
      * Make a decision whether a task should be scheduled to the local
      * channel or a remote.
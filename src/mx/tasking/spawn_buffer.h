@@ -0,0 +1,84 @@
+#pragma once
+
+#include "config.h"
+#include "task.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mx/util/queue.h>
+
+namespace mx::tasking {
+/**
+ * The spawn buffer collects tasks that are spawned by a worker to remote channels,
+ * grouped by the target channel and priority. All tasks staged for the same channel
+ * and priority are published to the remote queue at once, using a single atomic
+ * operation instead of one per task.
+ * The buffer is owned by a single worker and not thread safe.
+ */
+class SpawnBuffer
+{
+public:
+    constexpr SpawnBuffer() noexcept = default;
+    ~SpawnBuffer() noexcept = default;
+
+    /**
+     * Stages the given task for the given channel.
+     * @param channel_id Channel the task is scheduled to.
+     * @param task Task to stage.
+     */
+    void push_back(const std::uint16_t channel_id, TaskInterface *task) noexcept
+    {
+        auto &queues = _queues[channel_id];
+        if (std::all_of(queues.begin(), queues.end(), [](const auto &queue) { return queue.empty(); }))
+        {
+            _channels[_count_channels++] = channel_id;
+        }
+
+        queues[task->priority()].push_back(task);
+        ++_counts[channel_id][task->priority()];
+    }
+
+    /**
+     * @return True, when no task is staged.
+     */
+    [[nodiscard]] bool empty() const noexcept { return _count_channels == 0U; }
+
+    /**
+     * Hands out all staged tasks, grouped by channel and priority, and empties the buffer.
+     * Within every group, tasks are linked and ordered by their staging.
+     * @param publish Callback for every group, called with channel id, first and last task, and number of tasks.
+     */
+    template <typename F> void flush(F &&publish) noexcept
+    {
+        for (auto i = 0U; i < _count_channels; ++i)
+        {
+            const auto channel_id = _channels[i];
+            for (auto priority_ = 0U; priority_ < _queues[channel_id].size(); ++priority_)
+            {
+                auto &queue = _queues[channel_id][priority_];
+                if (queue.empty() == false)
+                {
+                    publish(channel_id, queue.begin(), queue.end(), _counts[channel_id][priority_]);
+                    queue.clear();
+                    _counts[channel_id][priority_] = 0U;
+                }
+            }
+        }
+
+        _count_channels = 0U;
+    }
+
+private:
+    // Staged tasks per channel and priority.
+    std::array<std::array<util::Queue<TaskInterface>, 3>, config::max_cores()> _queues{};
+
+    // Number of staged tasks per channel and priority.
+    std::array<std::array<std::uint32_t, 3>, config::max_cores()> _counts{};
+
+    // Channels that have staged tasks.
+    std::array<std::uint16_t, config::max_cores()> _channels{0U};
+
+    // Number of channels that have staged tasks.
+    std::uint16_t _count_channels{0U};
+};
+} // namespace mx::tasking
\ No newline at end of file
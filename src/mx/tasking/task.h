@@ -6,13 +6,15 @@
 #include <cstdint>
 #include <functional>
 #include <mx/resource/resource.h>
+#include <mx/system/tsc.h>
 #include <variant>
 
 namespace mx::tasking {
 enum priority : std::uint8_t
 {
     low = 0,
-    normal = 1
+    normal = 1,
+    high = 2
 };
 
 class TaskInterface;
@@ -62,6 +64,17 @@ public:
         return TaskResult{successor_task, true};
     }
 
+    /**
+     * Let the runtime know that the returning task is
+     * suspended while waiting for prefetched data. The
+     * worker will resume the task after executing
+     * other tasks, without re-scheduling it.
+     *
+     * @return A TaskResult that tells the runtime
+     *         to resume the returning task later.
+     */
+    static TaskResult make_suspend() noexcept { return TaskResult{nullptr, false, true}; }
+
     /**
      * Nothing will happen
      *
@@ -87,14 +100,53 @@ public:
 
     [[nodiscard]] bool is_remove() const noexcept { return _remove_task; }
     [[nodiscard]] bool has_successor() const noexcept { return _successor_task != nullptr; }
+    [[nodiscard]] bool is_suspended() const noexcept { return _suspend_task; }
 
 private:
-    constexpr TaskResult(TaskInterface *successor_task, const bool remove) noexcept
-        : _successor_task(successor_task), _remove_task(remove)
+    constexpr TaskResult(TaskInterface *successor_task, const bool remove, const bool suspend = false) noexcept
+        : _successor_task(successor_task), _remove_task(remove), _suspend_task(suspend)
     {
     }
     TaskInterface *_successor_task = nullptr;
     bool _remove_task = false;
+    bool _suspend_task = false;
+};
+
+/**
+ * Time stamp of the spawn of a task, used to measure the time the
+ * task waited in queues. The time stamp is only part of a task
+ * when enabled by config::task_queueing_statistics().
+ */
+template <bool IsRecorded> class SpawnTimestamp
+{
+public:
+    constexpr SpawnTimestamp() noexcept = default;
+    ~SpawnTimestamp() noexcept = default;
+
+    /**
+     * Records the time the task was spawned.
+     * @param timestamp Value of the time stamp counter.
+     */
+    void spawned(const std::uint64_t timestamp) noexcept { _spawn_timestamp = timestamp; }
+
+    /**
+     * @return Value of the time stamp counter when the task was spawned; zero, when not recorded.
+     */
+    [[nodiscard]] std::uint64_t spawn_timestamp() const noexcept { return _spawn_timestamp; }
+
+private:
+    // Time stamp counter value at spawn, recorded while task statistics are enabled.
+    std::uint64_t _spawn_timestamp{0U};
+};
+
+template <> class SpawnTimestamp<false>
+{
+public:
+    constexpr SpawnTimestamp() noexcept = default;
+    ~SpawnTimestamp() noexcept = default;
+
+    void spawned(const std::uint64_t /*timestamp*/) noexcept {}
+    [[nodiscard]] std::uint64_t spawn_timestamp() const noexcept { return 0U; }
 };
 
 /**
@@ -102,7 +154,7 @@ private:
  * Every task that should be executed has to derive
  * from this class.
  */
-class TaskInterface
+class TaskInterface : public SpawnTimestamp<config::task_queueing_statistics()>
 {
 public:
     using channel = std::uint16_t;
@@ -153,6 +205,21 @@ public:
      */
     void annotate(const priority priority_) noexcept { _annotation.priority = priority_; }
 
+    /**
+     * Annotate the task with a deadline. When the oldest task of a lower priority
+     * missed its deadline, the channel serves this priority before higher ones.
+     * Deadlines are stored with a resolution of 2^task_deadline_resolution() cycles
+     * and must not be more than 2^(15 + task_deadline_resolution()) cycles ahead.
+     *
+     * @param cycles Number of cycles (time stamp counter) from now.
+     */
+    void annotate_deadline(const std::uint64_t cycles) noexcept
+    {
+        // Zero is reserved for "no deadline".
+        const auto deadline = TaskInterface::deadline_ticks(system::tsc::read() + cycles);
+        _annotation.deadline = deadline != 0U ? deadline : 1U;
+    }
+
     /**
      * Annotate the task whether it is a reading or writing task.
      *
@@ -191,6 +258,32 @@ public:
      */
     [[nodiscard]] enum priority priority() const noexcept { return _annotation.priority; }
 
+    /**
+     * @return True, when the task has a deadline annotated.
+     */
+    [[nodiscard]] bool has_deadline() const noexcept { return _annotation.deadline != 0U; }
+
+    /**
+     * Checks whether the annotated deadline is missed.
+     * @param now Current time in deadline ticks, see deadline_ticks().
+     * @return True, when the task has a deadline that is missed.
+     */
+    [[nodiscard]] bool is_deadline_missed(const std::uint16_t now) const noexcept
+    {
+        // The difference is interpreted signed to survive the wrap-around of ticks.
+        return has_deadline() && std::int16_t(std::uint16_t(now - _annotation.deadline)) >= 0;
+    }
+
+    /**
+     * Converts a time stamp counter value into (wrapping) deadline ticks.
+     * @param cycles Value of the time stamp counter.
+     * @return Ticks used for deadlines.
+     */
+    [[nodiscard]] static std::uint16_t deadline_ticks(const std::uint64_t cycles) noexcept
+    {
+        return std::uint16_t(cycles >> config::task_deadline_resolution());
+    }
+
     /**
      * @return True, when the task is a read only task.
      */
@@ -249,6 +342,9 @@ private:
 
         // Target the task will run on.
         std::variant<channel, node, resource_and_size, bool> target{false};
+
+        // Deadline in ticks of the time stamp counter, zero when no deadline is annotated.
+        std::uint16_t deadline{0U};
     } __attribute__((packed));
 
     // Pointer for next task in queue.
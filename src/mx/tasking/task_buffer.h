@@ -60,6 +60,12 @@ public:
      */
     constexpr auto max_size() const noexcept { return S; }
 
+    /**
+     * Updates the prefetch distance; takes effect for tasks filled into the buffer afterwards.
+     * @param prefetch_distance New prefetch distance.
+     */
+    void prefetch_distance(const std::uint8_t prefetch_distance) noexcept { _prefetch_distance = prefetch_distance; }
+
     /**
      * @return Number of free slots.
      */
@@ -80,7 +86,7 @@ public:
 
 private:
     // Prefetch distance.
-    const std::uint8_t _prefetch_distance;
+    std::uint8_t _prefetch_distance;
 
     // Index of the first element in the buffer.
     std::uint16_t _head{0U};
@@ -5,7 +5,9 @@
 #include <cassert>
 #include <mx/system/builtin.h>
 #include <mx/system/topology.h>
+#include <mx/system/tsc.h>
 #include <mx/util/random.h>
+#include <typeinfo>
 
 using namespace mx::tasking;
 
@@ -14,8 +16,8 @@ Worker::Worker(const std::uint16_t id, const std::uint16_t target_core_id, const
                memory::reclamation::LocalEpoch &local_epoch,
                const std::atomic<memory::reclamation::epoch_t> &global_epoch, profiling::Statistic &statistic) noexcept
     : _target_core_id(target_core_id), _prefetch_distance(prefetch_distance),
-      _channel(id, target_numa_node_id, prefetch_distance), _local_epoch(local_epoch), _global_epoch(global_epoch),
-      _statistic(statistic), _is_running(is_running)
+      _prefetch_distance_controller(prefetch_distance), _channel(id, target_numa_node_id, prefetch_distance),
+      _local_epoch(local_epoch), _global_epoch(global_epoch), _statistic(statistic), _is_running(is_running)
 {
 }
 
@@ -30,6 +32,17 @@ void Worker::execute()
     const auto core_id = system::topology::core_id();
     assert(this->_target_core_id == core_id && "Worker not pinned to correct core.");
     const auto channel_id = this->_channel.id();
+    auto &metrics = this->_channel.metrics();
+    metrics.started();
+
+    // Counters are opened per thread and read in user space at task boundaries.
+    if constexpr (config::task_perf_counters())
+    {
+        this->_perf_counters.open();
+    }
+
+    // Start of the current idle range, zero while the worker finds tasks.
+    auto idle_start_timestamp = std::uint64_t{0U};
     while (this->_is_running)
     {
         if constexpr (config::memory_reclamation() == config::UpdateEpochPeriodically)
@@ -38,12 +51,76 @@ void Worker::execute()
         }
 
         this->_channel_size = this->_channel.fill();
+        metrics.filled();
+
+        if constexpr (config::work_stealing() && config::worker_parking())
+        {
+            this->wake_up_thief();
+        }
 
-        if constexpr (config::task_statistics())
+        if (diagnostics::is_statistics_enabled())
         {
             this->_statistic.increment<profiling::Statistic::Fill>(channel_id);
         }
 
+        // Nothing to do on the own channel; help out other channels.
+        if constexpr (config::work_stealing())
+        {
+            if (this->_channel_size == 0)
+            {
+                this->_channel_size = this->steal(channel_id);
+            }
+        }
+
+        // Nothing else to do; resume all suspended tasks once.
+        if (this->_channel_size == 0 && this->_count_suspended_tasks > 0U)
+        {
+            for (auto i = this->_count_suspended_tasks; i > 0U; --i)
+            {
+                this->resume_suspended(core_id, channel_id);
+            }
+            continue;
+        }
+
+        // The worker idles from the first empty fill until the next non-empty fill.
+        if (this->_channel_size == 0)
+        {
+            if (idle_start_timestamp == 0U)
+            {
+                idle_start_timestamp = system::tsc::read();
+            }
+        }
+        else if (idle_start_timestamp != 0U)
+        {
+            this->idled(metrics, idle_start_timestamp, system::tsc::read());
+            idle_start_timestamp = 0U;
+        }
+
+        // Idle time would distort the measured cycles per task.
+        if constexpr (config::adaptive_prefetch_distance())
+        {
+            if (this->_channel_size == 0)
+            {
+                this->_prefetch_distance_controller.idle();
+            }
+        }
+
+        // Back off and finally park instead of busy polling the empty channel.
+        if constexpr (config::worker_parking())
+        {
+            if (this->_channel_size == 0)
+            {
+                this->idle();
+            }
+            else
+            {
+                this->_count_idle_rounds = 0U;
+            }
+        }
+
+        // Every task is measured from the end of its predecessor, reading the
+        // time stamp counter only once per task.
+        auto last_timestamp = system::tsc::read();
         while ((task = this->_channel.next()) != nullptr)
         {
             // Whenever the worker-local task-buffer falls under
@@ -57,13 +134,18 @@ void Worker::execute()
                 }
 
                 this->_channel_size = this->_channel.fill();
-                if constexpr (config::task_statistics())
+                metrics.filled();
+                if constexpr (config::work_stealing() && config::worker_parking())
+                {
+                    this->wake_up_thief();
+                }
+                if (diagnostics::is_statistics_enabled())
                 {
                     this->_statistic.increment<profiling::Statistic::Fill>(channel_id);
                 }
             }
 
-            if constexpr (config::task_statistics())
+            if (diagnostics::is_statistics_enabled())
             {
                 this->_statistic.increment<profiling::Statistic::Executed>(channel_id);
                 if (task->has_resource_annotated())
@@ -79,64 +161,7 @@ void Worker::execute()
                 }
             }
 
-            // Based on the annotated resource and its synchronization
-            // primitive, we choose the fitting execution context.
-            auto result = TaskResult{};
-            auto task_id_profiler = 0;
-            switch (Worker::synchronization_primitive(task))
-            {
-            case synchronization::primitive::ScheduleWriter:
-                if constexpr (config::use_tasking_profiler()){
-                    task_id_profiler = TaskingProfiler::getInstance().startTask(core_id, 0, typeid(*task).name());
-                    result = this->execute_optimistic(core_id, channel_id, task);
-                    TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
-                }
-                else{
-                    result = this->execute_optimistic(core_id, channel_id, task);
-                }
-                break;
-            case synchronization::primitive::OLFIT:
-                if constexpr (config::use_tasking_profiler()){
-                    task_id_profiler = TaskingProfiler::getInstance().startTask(core_id, 0, typeid(*task).name());
-                    result = this->execute_olfit(core_id, channel_id, task);
-                    TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
-                }
-                else{
-                    result = this->execute_olfit(core_id, channel_id, task);
-                }    
-                break;
-            case synchronization::primitive::ScheduleAll:
-            case synchronization::primitive::None:
-                if constexpr (config::use_tasking_profiler()){
-                    task_id_profiler = TaskingProfiler::getInstance().startTask(core_id, 0, typeid(*task).name());
-                    result = task->execute(core_id, channel_id);
-                    TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
-                }
-                else{
-                    result = task->execute(core_id, channel_id);
-                }
-                break;
-            case synchronization::primitive::ReaderWriterLatch:
-                if constexpr (config::use_tasking_profiler()){
-                    task_id_profiler = TaskingProfiler::getInstance().startTask(core_id, 0, typeid(*task).name());
-                    result = Worker::execute_reader_writer_latched(core_id, channel_id, task);
-                    TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
-                }
-                else{
-                    result = Worker::execute_reader_writer_latched(core_id, channel_id, task);
-                }
-                break;
-            case synchronization::primitive::ExclusiveLatch:
-                if constexpr (config::use_tasking_profiler()){
-                    task_id_profiler = TaskingProfiler::getInstance().startTask(core_id, 0, typeid(*task).name());
-                    result = Worker::execute_exclusive_latched(core_id, channel_id, task);
-                    TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
-                }
-                else{
-                    result = Worker::execute_exclusive_latched(core_id, channel_id, task);
-                }
-                break;
-            }
+            const auto result = this->execute_task(core_id, channel_id, task);
 
             // The task-chain may be finished at time the
             // task has no successor. Otherwise, we spawn
@@ -146,12 +171,267 @@ void Worker::execute()
                 runtime::spawn(*static_cast<TaskInterface *>(result), channel_id);
             }
 
+            // Tasks spawned in a batch by the executed task
+            // will be published to their channels.
+            if (this->_spawn_buffer.empty() == false)
+            {
+                runtime::flush_spawn_batch(channel_id);
+            }
+
             if (result.is_remove())
             {
                 runtime::delete_task(core_id, task);
             }
+
+            // Suspended tasks wait for prefetched data while other tasks are
+            // executed. When the window is full, the oldest ones are resumed
+            // until a task finished and left the window.
+            if (result.is_suspended())
+            {
+                this->suspend(task);
+                while (this->_count_suspended_tasks > config::coroutine_interleaving())
+                {
+                    this->resume_suspended(core_id, channel_id);
+                }
+            }
+
+            const auto timestamp = system::tsc::read();
+            metrics.executed(timestamp - last_timestamp);
+            last_timestamp = timestamp;
+
+            if constexpr (config::adaptive_prefetch_distance())
+            {
+                if (this->_prefetch_distance_controller.executed())
+                {
+                    this->_prefetch_distance = this->_prefetch_distance_controller.prefetch_distance();
+                    this->_channel.prefetch_distance(std::uint8_t(this->_prefetch_distance));
+                }
+            }
         }
     }
+
+    if (idle_start_timestamp != 0U)
+    {
+        this->idled(metrics, idle_start_timestamp, system::tsc::read());
+    }
+
+    // Tasks suspended at shutdown are not resumed; their frames are freed.
+    while (this->_count_suspended_tasks > 0U)
+    {
+        auto *suspended_task = this->_suspended_tasks.pop_front();
+        --this->_count_suspended_tasks;
+        runtime::delete_task(core_id, suspended_task);
+    }
+
+    this->_perf_counters.close();
+}
+
+void Worker::idled(profiling::ChannelMetrics &metrics, const std::uint64_t start, const std::uint64_t end) noexcept
+{
+    metrics.idled(end - start);
+    auto *idle_range_log = this->_idle_range_log.load(std::memory_order_acquire);
+    if (idle_range_log != nullptr)
+    {
+        idle_range_log->push(start, end);
+    }
+}
+
+std::uint16_t Worker::steal([[maybe_unused]] const std::uint16_t channel_id) noexcept
+{
+    for (auto i = 0U; i < this->_count_steal_victims; ++i)
+    {
+        const auto size = this->_channel.steal(*this->_steal_victims[i]);
+        if (size > 0U)
+        {
+            if (diagnostics::is_statistics_enabled())
+            {
+                this->_statistic.increment<profiling::Statistic::Stolen>(channel_id, size);
+            }
+            return size;
+        }
+    }
+
+    return 0U;
+}
+
+void Worker::wake_up_thief() noexcept
+{
+    const auto is_full = this->_channel_size >= std::int32_t(config::task_buffer_size());
+    if (is_full == false || this->_channel.has_stealable_tasks() == false)
+    {
+        return;
+    }
+
+    for (auto i = 0U; i < this->_count_steal_victims; ++i)
+    {
+        auto *victim = this->_steal_victims[i];
+        if (victim->is_parked())
+        {
+            victim->wake_up();
+            return;
+        }
+    }
+}
+
+TaskResult Worker::execute_task(const std::uint16_t core_id, const std::uint16_t channel_id, TaskInterface *const task)
+{
+    // Queueing and execution time are recorded per task type as part of the statistics.
+    const auto *task_type = diagnostics::is_statistics_enabled() ? &typeid(*task) : nullptr;
+    const auto spawn_timestamp = task->spawn_timestamp();
+    const auto start_timestamp = task_type != nullptr ? system::tsc::read() : 0U;
+    const auto is_perf_counted = config::task_perf_counters() && task_type != nullptr && this->_perf_counters.is_open();
+    auto perf_counters_start = profiling::PerfCounters::values_t{};
+    if (is_perf_counted)
+    {
+        this->_perf_counters.read(perf_counters_start);
+    }
+
+    // Based on the annotated resource and its synchronization
+    // primitive, we choose the fitting execution context.
+    auto result = TaskResult{};
+    std::uint64_t task_id_profiler{0U};
+    switch (Worker::synchronization_primitive(task))
+    {
+    case synchronization::primitive::ScheduleWriter:
+        if (diagnostics::is_profiling_enabled()){
+            task_id_profiler = TaskingProfiler::getInstance().startTask(channel_id, 0, typeid(*task).name());
+            result = this->execute_optimistic(core_id, channel_id, task);
+            TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
+        }
+        else{
+            result = this->execute_optimistic(core_id, channel_id, task);
+        }
+        break;
+    case synchronization::primitive::OLFIT:
+        if (diagnostics::is_profiling_enabled()){
+            task_id_profiler = TaskingProfiler::getInstance().startTask(channel_id, 0, typeid(*task).name());
+            result = this->execute_olfit(core_id, channel_id, task);
+            TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
+        }
+        else{
+            result = this->execute_olfit(core_id, channel_id, task);
+        }    
+        break;
+    case synchronization::primitive::ScheduleAll:
+    case synchronization::primitive::None:
+        if (diagnostics::is_profiling_enabled()){
+            task_id_profiler = TaskingProfiler::getInstance().startTask(channel_id, 0, typeid(*task).name());
+            result = task->execute(core_id, channel_id);
+            TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
+        }
+        else{
+            result = task->execute(core_id, channel_id);
+        }
+        break;
+    case synchronization::primitive::ReaderWriterLatch:
+        if (diagnostics::is_profiling_enabled()){
+            task_id_profiler = TaskingProfiler::getInstance().startTask(channel_id, 0, typeid(*task).name());
+            result = Worker::execute_reader_writer_latched(core_id, channel_id, task);
+            TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
+        }
+        else{
+            result = Worker::execute_reader_writer_latched(core_id, channel_id, task);
+        }
+        break;
+    case synchronization::primitive::ExclusiveLatch:
+        if (diagnostics::is_profiling_enabled()){
+            task_id_profiler = TaskingProfiler::getInstance().startTask(channel_id, 0, typeid(*task).name());
+            result = Worker::execute_exclusive_latched(core_id, channel_id, task);
+            TaskingProfiler::getInstance().endTask(channel_id, task_id_profiler);
+        }
+        else{
+            result = Worker::execute_exclusive_latched(core_id, channel_id, task);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (is_perf_counted)
+    {
+        auto perf_counters = profiling::PerfCounters::values_t{};
+        this->_perf_counters.read(perf_counters);
+        for (auto event = 0U; event < perf_counters.size(); ++event)
+        {
+            perf_counters[event] -= perf_counters_start[event];
+        }
+        this->_statistic.record_perf_counters(channel_id, *task_type, perf_counters);
+    }
+
+    if (task_type != nullptr)
+    {
+        const auto end_timestamp = system::tsc::read();
+        const auto queueing_cycles =
+            spawn_timestamp != 0U && start_timestamp > spawn_timestamp ? start_timestamp - spawn_timestamp : 0U;
+        this->_statistic.record_latency(channel_id, *task_type, queueing_cycles, end_timestamp - start_timestamp);
+    }
+
+    return result;
+}
+
+void Worker::suspend(TaskInterface *const task) noexcept
+{
+    // Latches would be released and optimistic reads could not be repeated while the
+    // task is suspended; further, tasks of the channel would interleave with the task.
+    assert(Worker::synchronization_primitive(task) == synchronization::primitive::None &&
+           "Suspended tasks may not access synchronized resources.");
+
+    // The time until the task is resumed is recorded as queueing time.
+    if (config::task_queueing_statistics() && diagnostics::is_statistics_enabled())
+    {
+        task->spawned(system::tsc::read());
+    }
+
+    this->_suspended_tasks.push_back(task);
+    ++this->_count_suspended_tasks;
+}
+
+void Worker::resume_suspended(const std::uint16_t core_id, const std::uint16_t channel_id)
+{
+    auto *task = this->_suspended_tasks.pop_front();
+    --this->_count_suspended_tasks;
+
+    const auto result = this->execute_task(core_id, channel_id, task);
+    if (result.has_successor())
+    {
+        runtime::spawn(*static_cast<TaskInterface *>(result), channel_id);
+    }
+
+    if (this->_spawn_buffer.empty() == false)
+    {
+        runtime::flush_spawn_batch(channel_id);
+    }
+
+    if (result.is_remove())
+    {
+        runtime::delete_task(core_id, task);
+    }
+    else if (result.is_suspended())
+    {
+        this->suspend(task);
+    }
+}
+
+void Worker::idle() noexcept
+{
+    if (this->_count_idle_rounds < config::worker_spin_rounds())
+    {
+        for (auto i = 0U; i < (1U << this->_count_idle_rounds); ++i)
+        {
+            system::builtin::pause();
+        }
+        ++this->_count_idle_rounds;
+        return;
+    }
+
+    // A parked worker must not hold back the reclamation of memory.
+    if constexpr (config::memory_reclamation() == config::UpdateEpochPeriodically)
+    {
+        this->_local_epoch.leave();
+    }
+
+    this->_channel.park(this->_is_running);
+    this->_count_idle_rounds = 0U;
 }
 
 TaskResult Worker::execute_exclusive_latched(const std::uint16_t core_id, const std::uint16_t channel_id,
@@ -194,7 +474,8 @@ TaskResult Worker::execute_optimistic(const std::uint16_t core_id, const std::ui
         // re-running the task, whenever the version check failed.
         if (task->annotated_resource().channel_id() != channel_id)
         {
-            return this->execute_optimistic_read(core_id, channel_id, optimistic_resource, task);
+            return this->execute_optimistic_read(core_id, channel_id, synchronization::primitive::ScheduleWriter,
+                                                 optimistic_resource, task);
         }
 
         // Whenever the task is executed at the same channel
@@ -219,7 +500,8 @@ TaskResult Worker::execute_olfit(const std::uint16_t core_id, const std::uint16_
 
     if (task->is_readonly())
     {
-        return this->execute_optimistic_read(core_id, channel_id, optimistic_resource, task);
+        return this->execute_optimistic_read(core_id, channel_id, synchronization::primitive::OLFIT,
+                                             optimistic_resource, task);
     }
 
     // Writers, however, need to acquire the version to tell readers, that
@@ -233,6 +515,7 @@ TaskResult Worker::execute_olfit(const std::uint16_t core_id, const std::uint16_
 }
 
 TaskResult Worker::execute_optimistic_read(const std::uint16_t core_id, const std::uint16_t channel_id,
+                                           const synchronization::primitive primitive,
                                            resource::ResourceInterface *optimistic_resource, TaskInterface *const task)
 {
     if constexpr (config::memory_reclamation() == config::UpdateEpochOnRead)
@@ -245,6 +528,7 @@ TaskResult Worker::execute_optimistic_read(const std::uint16_t core_id, const st
     // the task was maybe modified.
     this->_task_stack.save(task);
 
+    auto failed_validations = 0U;
     do
     {
         const auto version = optimistic_resource->version();
@@ -256,11 +540,64 @@ TaskResult Worker::execute_optimistic_read(const std::uint16_t core_id, const st
             {
                 this->_local_epoch.leave();
             }
+
+            if (failed_validations > 0U)
+            {
+                this->record_failed_validations(channel_id, task, failed_validations, false);
+            }
             return result;
         }
 
         // At this point, the version check failed and we need
         // to re-run the read operation.
         this->_task_stack.restore(task);
+        ++failed_validations;
+
+        if constexpr (config::optimistic_read_fallback() > 0U)
+        {
+            if (failed_validations >= config::optimistic_read_fallback())
+            {
+                this->record_failed_validations(channel_id, task, failed_validations, true);
+                if (primitive == synchronization::primitive::OLFIT)
+                {
+                    // Writers on any channel acquire the latch by compare and swap; so can the reader.
+                    auto result_latched = TaskResult{};
+                    {
+                        resource::ResourceInterface::scoped_olfit_latch _{optimistic_resource};
+                        result_latched = task->execute(core_id, channel_id);
+                    }
+
+                    if constexpr (config::memory_reclamation() == config::UpdateEpochOnRead)
+                    {
+                        this->_local_epoch.leave();
+                    }
+                    return result_latched;
+                }
+
+                if constexpr (config::memory_reclamation() == config::UpdateEpochOnRead)
+                {
+                    this->_local_epoch.leave();
+                }
+
+                // Writers are serialized on the channel owning the resource,
+                // readers on that channel will not be interrupted.
+                runtime::spawn(*task);
+                return TaskResult::make_null();
+            }
+        }
     } while (true);
+}
+
+void Worker::record_failed_validations(const std::uint16_t channel_id, TaskInterface *const task,
+                                       const std::uint64_t failed_validations, const bool is_fallback) noexcept
+{
+    if (diagnostics::is_statistics_enabled())
+    {
+        this->_statistic.increment<profiling::Statistic::FailedValidations>(channel_id, failed_validations);
+        this->_statistic.record_failed_validations(channel_id, typeid(*task), failed_validations);
+        if (is_fallback)
+        {
+            this->_statistic.increment<profiling::Statistic::ValidationFallbacks>(channel_id);
+        }
+    }
 }
\ No newline at end of file
@@ -2,14 +2,21 @@
 
 #include "channel.h"
 #include "config.h"
+#include "diagnostics.h"
+#include "prefetch_distance_controller.h"
+#include "profiling/idle_profiler.h"
+#include "profiling/perf_counters.h"
 #include "profiling/statistic.h"
+#include "spawn_buffer.h"
 #include "task.h"
 #include "task_stack.h"
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <memory>
 #include <mx/memory/reclamation/epoch_manager.h>
 #include <mx/util/maybe_atomic.h>
+#include <mx/util/queue.h>
 #include <variant>
 #include <vector>
 
@@ -40,12 +47,36 @@ public:
     [[nodiscard]] Channel &channel() noexcept { return _channel; }
     [[nodiscard]] const Channel &channel() const noexcept { return _channel; }
 
+    /**
+     * @return Buffer for tasks spawned in a batch by tasks of this worker.
+     */
+    [[nodiscard]] SpawnBuffer &spawn_buffer() noexcept { return _spawn_buffer; }
+
+    /**
+     * Adds the channel of another worker as victim for work stealing.
+     * Victims are visited in the order they were added.
+     * @param victim Channel to steal tasks from.
+     */
+    void add_steal_victim(Channel &victim) noexcept { _steal_victims[_count_steal_victims++] = &victim; }
+
+    /**
+     * Logs every idle range of this worker into the given log.
+     * @param idle_range_log Log for idle ranges, nullptr disables logging.
+     */
+    void log_idle_ranges(profiling::IdleRangeLog *idle_range_log) noexcept
+    {
+        _idle_range_log.store(idle_range_log, std::memory_order_release);
+    }
+
 private:
     // Id of the logical core.
     const std::uint16_t _target_core_id;
 
     // Distance of prefetching tasks.
-    const std::uint16_t _prefetch_distance;
+    std::uint16_t _prefetch_distance;
+
+    // Controller for adapting the prefetch distance at runtime.
+    PrefetchDistanceController _prefetch_distance_controller;
 
     std::int32_t _channel_size{0U};
 
@@ -56,6 +87,9 @@ private:
     // Channel where tasks are stored for execution.
     alignas(64) Channel _channel;
 
+    // Tasks spawned in a batch to remote channels, published after every executed task.
+    alignas(64) SpawnBuffer _spawn_buffer;
+
     // Local epoch of this worker.
     memory::reclamation::LocalEpoch &_local_epoch;
 
@@ -68,6 +102,79 @@ private:
     // Flag for "running" state of MxTasking.
     const util::maybe_atomic<bool> &_is_running;
 
+    // Channels of other workers to steal tasks from, NUMA-local channels first.
+    std::array<Channel *, config::max_cores()> _steal_victims{nullptr};
+
+    // Number of victims for work stealing.
+    std::uint16_t _count_steal_victims{0U};
+
+    // Number of backoff rounds spent without finding a task.
+    std::uint32_t _count_idle_rounds{0U};
+
+    // Tasks (coroutines) suspended while waiting for prefetched data.
+    util::Queue<TaskInterface> _suspended_tasks;
+
+    // Number of suspended tasks.
+    std::uint16_t _count_suspended_tasks{0U};
+
+    // Log for idle ranges while profiling.
+    std::atomic<profiling::IdleRangeLog *> _idle_range_log{nullptr};
+
+    // Hardware performance counters of the worker thread, read around every task.
+    profiling::PerfCounters _perf_counters;
+
+    /**
+     * Steals tasks from the channels of other workers into the own channel.
+     * @param channel_id Id of the channel.
+     * @return Size of the channel after stealing.
+     */
+    std::uint16_t steal(std::uint16_t channel_id) noexcept;
+
+    /**
+     * Parked workers neither steal nor poll their victims. When the own channel is
+     * full and stealable tasks are left in its remote queues, a parked victim
+     * (which steals from this channel in turn) is woken up to help out.
+     */
+    void wake_up_thief() noexcept;
+
+    /**
+     * Executes the task within the execution context of its synchronization primitive;
+     * records its latency and performance counters, when statistics are enabled.
+     * @param core_id Id of the core.
+     * @param channel_id Id of the channel.
+     * @param task Task to be executed.
+     * @return Task to be scheduled after execution.
+     */
+    TaskResult execute_task(std::uint16_t core_id, std::uint16_t channel_id, TaskInterface *task);
+
+    /**
+     * Adds the task to the suspended tasks, to be resumed after executing other tasks.
+     * Suspended tasks may not access synchronized resources.
+     * @param task Task to suspend.
+     */
+    void suspend(TaskInterface *task) noexcept;
+
+    /**
+     * Resumes the oldest suspended task.
+     * @param core_id Id of the core.
+     * @param channel_id Id of the channel.
+     */
+    void resume_suspended(std::uint16_t core_id, std::uint16_t channel_id);
+
+    /**
+     * Backs off while the channel is empty; spins for an exponentially
+     * growing time and parks the worker after the last spin round.
+     */
+    void idle() noexcept;
+
+    /**
+     * Accounts a range of time the worker found no task.
+     * @param metrics Metrics of the channel.
+     * @param start Timestamp of the first empty fill.
+     * @param end Timestamp of the next non-empty fill.
+     */
+    void idled(profiling::ChannelMetrics &metrics, std::uint64_t start, std::uint64_t end) noexcept;
+
     /**
      * Analyzes the given task and chooses the execution method regarding synchronization.
      * @param task Task to be executed.
@@ -117,14 +224,27 @@ private:
     TaskResult execute_olfit(std::uint16_t core_id, std::uint16_t channel_id, TaskInterface *task);
 
     /**
-     * Executes the read-only task optimistically.
+     * Executes the read-only task optimistically. After too many failed
+     * validations (see config), the read falls back depending on the primitive.
      * @param core_id Id of the core.
      * @param channel_id Id of the channel.
+     * @param primitive Synchronization primitive of the resource (ScheduleWriter or OLFIT).
      * @param resource Resource the task reads.
      * @param task Task to be executed.
      * @return Task to be scheduled after execution.
      */
     TaskResult execute_optimistic_read(std::uint16_t core_id, std::uint16_t channel_id,
-                                       resource::ResourceInterface *resource, TaskInterface *task);
+                                       synchronization::primitive primitive, resource::ResourceInterface *resource,
+                                       TaskInterface *task);
+
+    /**
+     * Records failed validations of an optimistic read in the statistics.
+     * @param channel_id Id of the channel.
+     * @param task Task that read optimistically.
+     * @param failed_validations Number of failed validations.
+     * @param is_fallback True, when the read fell back after the validations.
+     */
+    void record_failed_validations(std::uint16_t channel_id, TaskInterface *task, std::uint64_t failed_validations,
+                                   bool is_fallback) noexcept;
 };
 } // namespace mx::tasking
\ No newline at end of file
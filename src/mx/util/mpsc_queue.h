@@ -61,6 +61,22 @@ public:
         return _tail == _end && reinterpret_cast<T const &>(_stub).next() == nullptr;
     }
 
+    /**
+     * Reads the first item without removing it from the queue.
+     * Like pop_front(), this may only be called by the consumer.
+     * @return The item that will be returned by the next pop_front(), or nullptr.
+     */
+    [[nodiscard]] T *front() const noexcept
+    {
+        auto *tail = this->_tail;
+        if (tail == this->_end)
+        {
+            return tail->next();
+        }
+
+        return tail;
+    }
+
     /**
      * @return Takes and removes the first item from the queue.
      */
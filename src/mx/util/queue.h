@@ -49,6 +49,11 @@ public:
      */
     [[nodiscard]] bool empty() const noexcept { return _head == nullptr; }
 
+    /**
+     * Empties the queue without touching the items.
+     */
+    void clear() noexcept { _head = _tail = nullptr; }
+
     /**
      * @return Takes and removes the first item from the queue.
      */
@@ -46,7 +46,7 @@ public:
         auto *data = std::exchange(_data, nullptr);
         if (data != nullptr)
         {
-            release(data, _capacity);
+            release(_numa_node_id, data, _capacity);
         }
     }
 
@@ -54,7 +54,7 @@ public:
     {
         if (_data != nullptr)
         {
-            release(_data, _capacity);
+            release(_numa_node_id, _data, _capacity);
         }
 
         _numa_node_id = other._numa_node_id;
@@ -69,7 +69,7 @@ public:
     {
         if (_data != nullptr)
         {
-            release(_data, _capacity);
+            release(_numa_node_id, _data, _capacity);
         }
 
         _numa_node_id = other._numa_node_id;
@@ -79,8 +79,11 @@ public:
         return *this;
     }
 
-    void reserve(const size_type n)
+    void reserve(const size_type n) { reserve(_numa_node_id, n); }
+
+    void reserve(const std::uint8_t numa_node_id, const size_type n)
     {
+        const auto old_numa_node_id = std::exchange(_numa_node_id, numa_node_id);
         auto *old_data = std::exchange(_data, allocate(_numa_node_id, n));
         const auto old_capacity = std::exchange(_capacity, n);
 
@@ -91,16 +94,10 @@ public:
                 std::memcpy(_data, old_data, sizeof(value_type) * _current_index);
             }
 
-            release(old_data, old_capacity);
+            release(old_numa_node_id, old_data, old_capacity);
         }
     }
 
-    void reserve(const std::uint8_t numa_node_id, const size_type n)
-    {
-        _numa_node_id = numa_node_id;
-        reserve(n);
-    }
-
     [[nodiscard]] size_type size() const noexcept { return _current_index; }
 
     [[nodiscard]] size_type capacity() const noexcept { return _capacity; }
@@ -165,10 +162,10 @@ private:
         return data;
     }
 
-    static void release(pointer_type data, const std::size_t capacity) noexcept
+    static void release(const std::uint8_t numa_node_id, pointer_type data, const std::size_t capacity) noexcept
     {
         const auto size = sizeof(value_type) * capacity;
-        memory::GlobalHeap::free(static_cast<void *>(data), size);
+        memory::GlobalHeap::free(static_cast<void *>(data), size, numa_node_id);
     }
 };
 } // namespace mx::util
\ No newline at end of file
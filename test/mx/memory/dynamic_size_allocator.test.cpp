@@ -1,5 +1,7 @@
+#include <chrono>
 #include <gtest/gtest.h>
 #include <mx/memory/dynamic_size_allocator.h>
+#include <mx/memory/global_heap.h>
 
 TEST(MxTasking, DynamicSizeAllocator)
 {
@@ -20,4 +22,92 @@ TEST(MxTasking, DynamicSizeAllocator)
 
     // Different allocations, different blocks
     EXPECT_NE(allocator.allocate(0U, 64U, sizeof(std::uint32_t)), allocator.allocate(0U, 64U, sizeof(std::uint32_t)));
+}
+
+TEST(MxTasking, DynamicSizeAllocatorLargeObjects)
+{
+    auto allocator = mx::memory::dynamic::Allocator{};
+
+    // Objects larger than the size classes are allocated from allocation blocks.
+    auto *small = allocator.allocate(0U, 64U, 1024U);
+    auto *large = allocator.allocate(0U, 64U, 8192U);
+    EXPECT_NE(small, nullptr);
+    EXPECT_NE(large, nullptr);
+    EXPECT_TRUE((std::uintptr_t(large) & 0x3F) == 0U);
+
+    allocator.free(small);
+    EXPECT_FALSE(allocator.is_free());
+    allocator.free(large);
+    EXPECT_TRUE(allocator.is_free());
+}
+
+TEST(MxTasking, DynamicSizeAllocatorMemoryLimit)
+{
+    auto allocator = mx::memory::dynamic::Allocator{};
+
+    // Objects are accounted in allocation blocks, including their header.
+    auto *large = allocator.allocate(0U, 64U, 1U << 20U);
+    ASSERT_NE(large, nullptr);
+    const auto usage = allocator.usage(0U);
+    EXPECT_EQ(usage.reserved, 4096U * 4096U);
+    EXPECT_GT(usage.in_use, 1U << 20U);
+    EXPECT_EQ(usage.fragmented, 0U);
+
+    // Beyond the hard limit, no further block is allocated...
+    mx::memory::GlobalHeap::limit(0U, mx::memory::MemoryLimit{0U, mx::memory::GlobalHeap::reserved(0U)});
+    EXPECT_EQ(allocator.allocate(0U, 64U, 32U << 20U), nullptr);
+    EXPECT_EQ(allocator.count_refused_allocations(0U), 1U);
+
+    // ... but free memory is still used.
+    auto *small = allocator.allocate(0U, 64U, 64U);
+    EXPECT_NE(small, nullptr);
+    allocator.free(small);
+
+    mx::memory::GlobalHeap::limit(0U, mx::memory::MemoryLimit{});
+    auto *huge = allocator.allocate(0U, 64U, 32U << 20U);
+    EXPECT_NE(huge, nullptr);
+    EXPECT_EQ(allocator.usage(0U).reserved, 4096UL * 4096UL + (1UL << 28U));
+
+    allocator.free(large);
+    allocator.free(huge);
+    EXPECT_TRUE(allocator.is_free());
+}
+
+TEST(MxTasking, DynamicSizeAllocatorTrim)
+{
+    using namespace std::chrono_literals;
+    auto allocator = mx::memory::dynamic::Allocator{};
+    const auto now = std::chrono::steady_clock::now();
+
+    // Blocks in use are not trimmed.
+    auto *large = static_cast<std::uint8_t *>(allocator.allocate(0U, 64U, 1U << 20U));
+    ASSERT_NE(large, nullptr);
+    large[0U] = 42U;
+    EXPECT_EQ(allocator.trim(now, 0ms), 0U);
+    EXPECT_EQ(allocator.trim(now + 1s, 0ms), 0U);
+
+    // Free blocks are trimmed after staying free for the given time, once.
+    allocator.free(large);
+    EXPECT_EQ(allocator.trim(now + 2s, 1s), 0U);
+    EXPECT_EQ(allocator.trim(now + 2500ms, 1s), 0U);
+    const auto reserved = mx::memory::GlobalHeap::reserved(0U);
+    EXPECT_EQ(allocator.trim(now + 3s, 1s), 4096U * 4096U);
+    EXPECT_EQ(allocator.trim(now + 4s, 1s), 0U);
+    EXPECT_TRUE(allocator.is_free());
+
+    // Trimmed memory is accounted as released.
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved - 4096U * 4096U);
+    EXPECT_EQ(allocator.usage(0U).reserved, 0U);
+
+    // Trimmed blocks are allocated again, backed by zeroed pages, and accounted as reserved.
+    auto *reused = static_cast<std::uint8_t *>(allocator.allocate(0U, 64U, 1U << 20U));
+    ASSERT_EQ(reused, large);
+    EXPECT_EQ(reused[0U], 0U);
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved);
+    EXPECT_EQ(allocator.usage(0U).reserved, 4096U * 4096U);
+
+    // Allocations reset the time a block stayed free.
+    allocator.free(reused);
+    EXPECT_EQ(allocator.trim(now + 5s, 1s), 0U);
+    EXPECT_EQ(allocator.trim(now + 6s, 1s), 4096U * 4096U);
 }
\ No newline at end of file
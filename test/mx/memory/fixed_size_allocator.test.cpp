@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <array>
 #include <gtest/gtest.h>
 #include <mx/memory/fixed_size_allocator.h>
+#include <mx/memory/global_heap.h>
+#include <vector>
 
 TEST(MxTasking, FixedSizeAllocator)
 {
@@ -52,4 +56,67 @@ TEST(MxTasking, FixedSizeAllocator)
         allocator.free(1U, m2);
         EXPECT_EQ(allocator.allocate(1U), m2);
     }
+}
+
+TEST(MxTasking, FixedSizeAllocatorCrossNodeFree)
+{
+    // Two processor heaps, both backed by node 0, stand for two NUMA nodes.
+    auto processor_heaps = std::array<mx::memory::fixed::ProcessorHeap, mx::memory::config::max_numa_nodes()>{};
+    processor_heaps[0U] = mx::memory::fixed::ProcessorHeap{0U};
+    processor_heaps[1U] = mx::memory::fixed::ProcessorHeap{0U};
+    auto core_heap_0 = mx::memory::fixed::CoreHeap<64U>{processor_heaps.data(), 0U};
+    auto core_heap_1 = mx::memory::fixed::CoreHeap<64U>{processor_heaps.data(), 1U};
+
+    auto objects = std::vector<void *>{};
+    for (auto i = 0U; i < mx::memory::config::cross_node_free_batch_size(); ++i)
+    {
+        objects.push_back(core_heap_1.allocate());
+        EXPECT_TRUE(processor_heaps[1U].contains(objects.back()));
+        EXPECT_FALSE(processor_heaps[0U].contains(objects.back()));
+    }
+
+    // Objects of the other node are not reused by the freeing core...
+    for (auto i = 0U; i < objects.size() - 1U; ++i)
+    {
+        core_heap_0.free(objects[i]);
+    }
+    EXPECT_EQ(core_heap_0.count_cross_node_frees(1U), objects.size() - 1U);
+    EXPECT_EQ(core_heap_0.count_cross_node_frees(0U), 0U);
+    EXPECT_TRUE(processor_heaps[0U].contains(core_heap_0.allocate()));
+    EXPECT_EQ(processor_heaps[1U].take_returned(), nullptr);
+
+    // ... but handed back to their node, once the batch is full.
+    core_heap_0.free(objects.back());
+    auto *returned = processor_heaps[1U].take_returned();
+    ASSERT_NE(returned, nullptr);
+    auto count_returned = 0U;
+    for (; returned != nullptr; returned = returned->next())
+    {
+        EXPECT_NE(std::find(objects.begin(), objects.end(), returned), objects.end());
+        ++count_returned;
+    }
+    EXPECT_EQ(count_returned, objects.size());
+
+    // Objects of the own node stay at the core.
+    auto *local = core_heap_1.allocate();
+    core_heap_1.free(local);
+    EXPECT_EQ(core_heap_1.allocate(), local);
+    EXPECT_EQ(core_heap_1.count_cross_node_frees(0U), 0U);
+}
+
+TEST(MxTasking, FixedSizeAllocatorRelease)
+{
+    const auto reserved = mx::memory::GlobalHeap::reserved(0U);
+
+    {
+        auto core_set = mx::util::core_set{};
+        core_set.emplace_back(0U);
+
+        auto allocator = mx::memory::fixed::Allocator<64U>{core_set};
+        EXPECT_NE(allocator.allocate(0U), nullptr);
+        EXPECT_GT(mx::memory::GlobalHeap::reserved(0U), reserved);
+    }
+
+    // Memory regions are returned as a whole.
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved);
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include <cstring>
+#include <gtest/gtest.h>
+#include <mx/memory/global_heap.h>
+
+TEST(MxTasking, GlobalHeapHugePages)
+{
+    constexpr auto size = 4UL << 20U;
+    const auto before = mx::memory::GlobalHeap::huge_page_memory();
+
+    auto *memory = mx::memory::GlobalHeap::allocate(0U, size);
+    ASSERT_NE(memory, nullptr);
+    std::memset(memory, 1, size);
+
+    // Memory of huge pages is aligned to the huge page size.
+    const auto after = mx::memory::GlobalHeap::huge_page_memory();
+    if constexpr (mx::memory::config::huge_page_size() > 0U)
+    {
+        EXPECT_EQ(std::uintptr_t(memory) % mx::memory::config::huge_page_size(), 0U);
+        EXPECT_EQ(after.allocated_explicit + after.allocated_transparent,
+                  before.allocated_explicit + before.allocated_transparent + size);
+    }
+    else
+    {
+        EXPECT_EQ(after.allocated_explicit + after.allocated_transparent, 0U);
+    }
+
+    mx::memory::GlobalHeap::free(memory, size, 0U);
+}
\ No newline at end of file
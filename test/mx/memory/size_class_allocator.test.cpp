@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mx/memory/global_heap.h>
+#include <mx/memory/size_class_allocator.h>
+#include <thread>
+#include <vector>
+
+TEST(MxTasking, SizeClassAllocatorSizeClass)
+{
+    using allocator = mx::memory::dynamic::SizeClassAllocator;
+
+    EXPECT_EQ(allocator::size_class(64U, 4U), 0U);
+    EXPECT_EQ(allocator::size_class(64U, 65U), 1U);
+    EXPECT_EQ(allocator::size_class(64U, 1024U), 4U);
+    EXPECT_EQ(allocator::size_class(2048U, 64U), 5U);
+    EXPECT_EQ(allocator::object_size(allocator::size_class(64U, 4096U)), 4096U);
+    EXPECT_EQ(allocator::size_class(64U, 4097U), mx::memory::config::count_size_classes());
+}
+
+TEST(MxTasking, SizeClassAllocator)
+{
+    auto allocator = std::make_unique<mx::memory::dynamic::SizeClassAllocator>();
+    EXPECT_TRUE(allocator->is_free());
+
+    auto *object = allocator->allocate(0U, 4U);
+    ASSERT_NE(object, nullptr);
+    EXPECT_EQ(std::uintptr_t(object) % 1024U, 0U);
+    EXPECT_FALSE(allocator->is_free());
+
+    // Objects of other allocators are not freed.
+    auto foreign = std::uint64_t{0U};
+    EXPECT_FALSE(allocator->free(&foreign));
+
+    EXPECT_TRUE(allocator->free(object));
+    EXPECT_TRUE(allocator->is_free());
+
+    // Objects are allocated by one and freed by another thread.
+    auto objects = std::vector<void *>{};
+    for (auto i = 0U; i < 1000U; ++i)
+    {
+        objects.push_back(allocator->allocate(0U, 0U));
+        ASSERT_NE(objects.back(), nullptr);
+    }
+
+    // Objects are accounted per size class, spans are reserved from the OS.
+    const auto usage = allocator->usage(0U, 0U);
+    EXPECT_EQ(usage.reserved, mx::memory::config::size_class_span_size());
+    EXPECT_EQ(usage.in_use, 1000U * mx::memory::config::min_size_class());
+    EXPECT_EQ(usage.fragmented, usage.reserved - usage.in_use);
+    EXPECT_EQ(allocator->usage(0U, 1U).reserved, 0U);
+
+    std::thread{[&allocator, &objects] {
+        for (auto *freed_object : objects)
+        {
+            EXPECT_TRUE(allocator->free(freed_object));
+        }
+    }}.join();
+    EXPECT_TRUE(allocator->is_free());
+
+    // Freed objects are allocated again.
+    auto *reused_object = allocator->allocate(0U, 0U);
+    EXPECT_NE(std::find(objects.begin(), objects.end(), reused_object), objects.end());
+    allocator->free(reused_object);
+
+    EXPECT_EQ(allocator->usage(0U, 0U).in_use, 0U);
+
+    const auto reserved = mx::memory::GlobalHeap::reserved(0U);
+    allocator->release();
+    EXPECT_TRUE(allocator->is_free());
+    EXPECT_EQ(allocator->usage(0U, 0U).reserved, 0U);
+
+    // Spans of both size classes are given back.
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved - 2U * mx::memory::config::size_class_span_size());
+}
+
+TEST(MxTasking, SizeClassAllocatorTrim)
+{
+    using namespace std::chrono_literals;
+    using allocator_t = mx::memory::dynamic::SizeClassAllocator;
+
+    constexpr auto size_class = std::uint8_t{6U};
+    constexpr auto span_size = mx::memory::config::size_class_span_size();
+    constexpr auto count_objects = span_size / allocator_t::object_size(size_class);
+
+    auto allocator = std::make_unique<allocator_t>();
+    const auto reserved = mx::memory::GlobalHeap::reserved(0U);
+
+    // Fill the first span, the last object is carved from the second span.
+    auto objects = std::vector<void *>{};
+    for (auto i = 0U; i <= count_objects; ++i)
+    {
+        objects.push_back(allocator->allocate(0U, size_class));
+        ASSERT_NE(objects.back(), nullptr);
+    }
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved + 2U * span_size);
+
+    for (auto i = 0U; i < count_objects; ++i)
+    {
+        EXPECT_TRUE(allocator->free(objects[i]));
+    }
+
+    // The span has to stay free for the given time, the span in use is kept.
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_EQ(allocator->trim(now, 1s), 0U);
+    EXPECT_EQ(allocator->trim(now + 500ms, 1s), 0U);
+    EXPECT_EQ(allocator->trim(now + 1s, 1s), span_size);
+    EXPECT_EQ(allocator->trim(now + 2s, 1s), 0U);
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved + span_size);
+    EXPECT_EQ(allocator->usage(0U, size_class).reserved, span_size);
+    EXPECT_EQ(allocator->usage(0U, size_class).in_use, allocator_t::object_size(size_class));
+
+    // Once the second span is exhausted, the trimmed span is reserved and carved again.
+    auto reused_objects = std::vector<void *>{};
+    for (auto i = 0U; i < count_objects; ++i)
+    {
+        reused_objects.push_back(allocator->allocate(0U, size_class));
+        ASSERT_NE(reused_objects.back(), nullptr);
+    }
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved + 2U * span_size);
+    EXPECT_NE(std::find(objects.begin(), objects.end(), reused_objects.back()), objects.end());
+
+    EXPECT_TRUE(allocator->free(objects.back()));
+    for (auto *object : reused_objects)
+    {
+        EXPECT_TRUE(allocator->free(object));
+    }
+    EXPECT_TRUE(allocator->is_free());
+
+    allocator->release();
+    EXPECT_EQ(mx::memory::GlobalHeap::reserved(0U), reserved);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mx/system/tsc.h>
+#include <thread>
+
+TEST(MxTasking, TscMonotonic)
+{
+    auto previous = mx::system::tsc::read_ordered();
+    for (auto i = 0U; i < 10000U; ++i)
+    {
+        const auto timestamp = mx::system::tsc::read_ordered();
+        EXPECT_GE(timestamp, previous);
+        previous = timestamp;
+    }
+
+    // Unserialized reads may be reordered with surrounding instructions, but not with each other.
+    previous = mx::system::tsc::read();
+    for (auto i = 0U; i < 10000U; ++i)
+    {
+        const auto timestamp = mx::system::tsc::read();
+        EXPECT_GE(timestamp, previous);
+        previous = timestamp;
+    }
+}
+
+TEST(MxTasking, TscToNanoseconds)
+{
+    EXPECT_GT(mx::system::tsc::ticks_per_nanosecond(), 0.0);
+    EXPECT_EQ(mx::system::tsc::to_nanoseconds(0U), 0U);
+
+    // Converted ticks agree with the steady clock across a sleep.
+    const auto clock_start = std::chrono::steady_clock::now();
+    const auto tsc_start = mx::system::tsc::read_ordered();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto tsc_end = mx::system::tsc::read_ordered();
+    const auto clock_end = std::chrono::steady_clock::now();
+
+    const auto clock_nanoseconds =
+        double(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_start).count());
+    const auto tsc_nanoseconds = double(mx::system::tsc::to_nanoseconds(tsc_end - tsc_start));
+    EXPECT_NEAR(tsc_nanoseconds, clock_nanoseconds, clock_nanoseconds * 0.05);
+}
\ No newline at end of file
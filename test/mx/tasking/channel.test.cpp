@@ -0,0 +1,219 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mx/system/tsc.h>
+#include <mx/tasking/channel.h>
+#include <mx/util/maybe_atomic.h>
+#include <thread>
+
+namespace {
+/**
+ * Task that is only scheduled, never executed.
+ */
+class ScheduledTask final : public mx::tasking::TaskInterface
+{
+public:
+    ScheduledTask() noexcept = default;
+    ~ScheduledTask() override = default;
+
+    mx::tasking::TaskResult execute(const std::uint16_t /*core_id*/, const std::uint16_t /*channel_id*/) override
+    {
+        return mx::tasking::TaskResult::make_remove();
+    }
+};
+
+/**
+ * Schedules a buffer full of high prioritized tasks.
+ *
+ * @param channel Channel to schedule the tasks to.
+ * @param high_tasks Storage of the tasks; tasks not filled stay scheduled.
+ */
+void push_high(mx::tasking::Channel &channel, std::deque<ScheduledTask> &high_tasks)
+{
+    for (auto i = 0U; i < mx::tasking::config::task_buffer_size(); ++i)
+    {
+        auto &high_task = high_tasks.emplace_back();
+        high_task.annotate(mx::tasking::priority::high);
+        channel.push_back_local(&high_task);
+    }
+}
+
+/**
+ * Schedules a buffer full of high prioritized tasks, fills, and takes the filled tasks.
+ *
+ * @param channel Channel to fill.
+ * @param high_tasks Storage of the high prioritized tasks.
+ * @param task Task to look for.
+ * @return True, if the task was filled.
+ */
+bool fill_high(mx::tasking::Channel &channel, std::deque<ScheduledTask> &high_tasks,
+               const mx::tasking::TaskInterface *task)
+{
+    push_high(channel, high_tasks);
+
+    auto is_filled = false;
+    const auto size = channel.fill();
+    for (auto i = 0U; i < size; ++i)
+    {
+        is_filled |= channel.next() == task;
+    }
+
+    return is_filled;
+}
+} // namespace
+
+TEST(MxTasking, ChannelPriority)
+{
+    auto channel = std::make_unique<mx::tasking::Channel>(0U, 0U, 0U, 0U);
+    auto tasks = std::array<ScheduledTask, 3U>{};
+    tasks[0U].annotate(mx::tasking::priority::low);
+    tasks[2U].annotate(mx::tasking::priority::high);
+    channel->push_back_local(&tasks[0U]);
+    channel->push_back_remote(&tasks[1U], 0U);
+    channel->push_back_local(&tasks[2U]);
+
+    EXPECT_EQ(channel->fill(), 2U);
+    EXPECT_EQ(channel->next(), &tasks[2U]);
+    EXPECT_EQ(channel->next(), &tasks[1U]);
+
+    // Low prioritized tasks are filled when no other task is available.
+    EXPECT_EQ(channel->fill(), 1U);
+    EXPECT_EQ(channel->next(), &tasks[0U]);
+}
+
+TEST(MxTasking, ChannelPriorityWithoutAging)
+{
+    auto channel = std::make_unique<mx::tasking::Channel>(0U, 0U, 0U, 0U);
+    auto high_tasks = std::deque<ScheduledTask>{};
+    auto task = ScheduledTask{};
+    channel->push_back_local(&task);
+
+    // The normal prioritized task starves while the buffer is filled with high prioritized tasks.
+    for (auto i = 0U; i < 64U; ++i)
+    {
+        EXPECT_FALSE(fill_high(*channel, high_tasks, &task));
+    }
+
+    EXPECT_EQ(channel->fill(), 1U);
+    EXPECT_EQ(channel->next(), &task);
+}
+
+TEST(MxTasking, ChannelPriorityAging)
+{
+    constexpr auto aging_fills = 4U;
+    auto channel = std::make_unique<mx::tasking::Channel>(0U, 0U, 0U, aging_fills);
+    auto high_tasks = std::deque<ScheduledTask>{};
+    auto task = ScheduledTask{};
+    channel->push_back_remote(&task, 0U);
+
+    // The normal prioritized task is served after being passed over by the given number of fills.
+    for (auto i = 0U; i < aging_fills; ++i)
+    {
+        EXPECT_FALSE(fill_high(*channel, high_tasks, &task));
+    }
+    EXPECT_TRUE(fill_high(*channel, high_tasks, &task));
+
+    // Aged tasks take at most half of the buffer, the rest is filled with high prioritized tasks.
+    // The aged fill already counts as passed over, since high prioritized tasks filled the buffer.
+    auto aged_tasks = std::array<ScheduledTask, mx::tasking::config::task_buffer_size()>{};
+    for (auto &aged_task : aged_tasks)
+    {
+        channel->push_back_local(&aged_task);
+    }
+    for (auto i = 1U; i < aging_fills; ++i)
+    {
+        EXPECT_FALSE(fill_high(*channel, high_tasks, &aged_tasks[0U]));
+    }
+
+    push_high(*channel, high_tasks);
+    EXPECT_EQ(channel->fill(), mx::tasking::config::task_buffer_size());
+    for (auto i = 0U; i < mx::tasking::config::task_buffer_size() / 2U; ++i)
+    {
+        EXPECT_EQ(channel->next(), &aged_tasks[i]);
+    }
+    for (auto i = 0U; i < mx::tasking::config::task_buffer_size() / 2U; ++i)
+    {
+        EXPECT_EQ(channel->next()->priority(), mx::tasking::priority::high);
+    }
+}
+
+TEST(MxTasking, ChannelDeadlineMissed)
+{
+    auto channel = std::make_unique<mx::tasking::Channel>(0U, 0U, 0U, 0U);
+    auto tasks = std::array<ScheduledTask, 4U>{};
+    const auto now = [] { return mx::tasking::TaskInterface::deadline_ticks(mx::system::tsc::read()); };
+
+    // Tasks without deadline never miss one.
+    tasks[0U].annotate(mx::tasking::priority::low);
+    channel->push_back_remote(&tasks[0U], 0U);
+    EXPECT_FALSE(channel->is_deadline_missed<mx::tasking::priority::low>(now()));
+
+    // Only the oldest task of a queue is checked.
+    tasks[1U].annotate_deadline(0U);
+    channel->push_back_local(&tasks[1U]);
+    tasks[2U].annotate_deadline(0U);
+    tasks[2U].annotate(mx::tasking::priority::low);
+    channel->push_back_remote(&tasks[2U], 0U);
+    EXPECT_TRUE(channel->is_deadline_missed<mx::tasking::priority::normal>(now()));
+    EXPECT_FALSE(channel->is_deadline_missed<mx::tasking::priority::low>(now()));
+    EXPECT_FALSE(channel->is_deadline_missed<mx::tasking::priority::high>(now()));
+
+    // Deadlines in the future are not missed.
+    tasks[3U].annotate_deadline(std::uint64_t{1U} << 30U);
+    tasks[3U].annotate(mx::tasking::priority::high);
+    channel->push_back_local(&tasks[3U]);
+    EXPECT_FALSE(channel->is_deadline_missed<mx::tasking::priority::high>(now()));
+
+    // Filled tasks are not checked.
+    EXPECT_EQ(channel->fill(), 2U);
+    EXPECT_EQ(channel->next(), &tasks[3U]);
+    EXPECT_EQ(channel->next(), &tasks[1U]);
+    EXPECT_FALSE(channel->is_deadline_missed<mx::tasking::priority::normal>(now()));
+
+    EXPECT_EQ(channel->fill(), 2U);
+    EXPECT_EQ(channel->next(), &tasks[0U]);
+    EXPECT_EQ(channel->next(), &tasks[2U]);
+}
+
+TEST(MxTasking, ChannelParking)
+{
+    auto channel = std::make_unique<mx::tasking::Channel>(0U, 0U, 0U, 0U, true);
+    auto is_running = mx::util::maybe_atomic<bool>{true};
+    auto task = ScheduledTask{};
+    auto count_executed = std::atomic_uint32_t{0U};
+
+    // The worker parks while its channel is empty and executes filled tasks.
+    auto worker = std::thread{[&channel, &is_running, &task, &count_executed] {
+        while (count_executed.load() == 0U)
+        {
+            const auto size = channel->fill();
+            if (size == 0U)
+            {
+                channel->park(is_running);
+            }
+
+            for (auto i = 0U; i < size; ++i)
+            {
+                auto *next_task = channel->next();
+                EXPECT_EQ(next_task, &task);
+                next_task->execute(0U, 0U);
+                count_executed.fetch_add(1U);
+            }
+        }
+    }};
+
+    while (channel->is_parked() == false)
+    {
+        std::this_thread::yield();
+    }
+
+    // Tasks scheduled to the remote queues wake up the parked worker.
+    channel->push_back_remote(&task, 0U);
+    worker.join();
+
+    EXPECT_EQ(count_executed.load(), 1U);
+    EXPECT_FALSE(channel->is_parked());
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mx/tasking/runtime.h>
+#include <mx/util/core_set.h>
+
+namespace {
+/**
+ * Counts its destruction, e.g., when the frame of a suspended coroutine is freed.
+ */
+class DestructionCounter
+{
+public:
+    explicit DestructionCounter(std::atomic_uint32_t &count_destroyed) noexcept : _count_destroyed(count_destroyed) {}
+    ~DestructionCounter() noexcept { _count_destroyed.fetch_add(1U); }
+
+private:
+    std::atomic_uint32_t &_count_destroyed;
+};
+
+/**
+ * Sums up the values after prefetching each of them; the last finished coroutine stops the runtime.
+ */
+mx::tasking::Coroutine sum(std::array<std::uint64_t, 4U> &values, std::atomic_uint64_t &result,
+                           std::atomic_uint32_t &count_pending)
+{
+    auto local_result = std::uint64_t{0U};
+    for (auto &value : values)
+    {
+        co_await mx::tasking::runtime::prefetch(mx::resource::ptr{&value}, sizeof(value));
+        local_result += value;
+    }
+
+    result.fetch_add(local_result);
+    if (count_pending.fetch_sub(1U) == 1U)
+    {
+        mx::tasking::runtime::stop();
+    }
+}
+
+/**
+ * Prefetches the value forever; the last started coroutine stops the runtime.
+ */
+mx::tasking::Coroutine prefetch_forever(std::uint64_t &value, std::atomic_uint32_t &count_pending,
+                                        std::atomic_uint32_t &count_destroyed)
+{
+    auto counter = DestructionCounter{count_destroyed};
+    if (count_pending.fetch_sub(1U) == 1U)
+    {
+        mx::tasking::runtime::stop();
+    }
+
+    while (true)
+    {
+        co_await mx::tasking::runtime::prefetch(mx::resource::ptr{&value}, sizeof(value));
+    }
+}
+
+/**
+ * Spawns the coroutines as tasks; coroutine frames are allocated by the worker.
+ */
+template <typename F> class SpawnCoroutinesTask final : public mx::tasking::TaskInterface
+{
+public:
+    SpawnCoroutinesTask(const std::uint32_t count_coroutines, F &&create_coroutine) noexcept
+        : _count_coroutines(count_coroutines), _create_coroutine(std::move(create_coroutine))
+    {
+    }
+    ~SpawnCoroutinesTask() override = default;
+
+    mx::tasking::TaskResult execute(const std::uint16_t core_id, const std::uint16_t channel_id) override
+    {
+        for (auto i = 0U; i < _count_coroutines; ++i)
+        {
+            auto *task = mx::tasking::runtime::new_task<mx::tasking::CoroutineTask>(core_id, _create_coroutine());
+            mx::tasking::runtime::spawn(*task, channel_id);
+        }
+
+        return mx::tasking::TaskResult::make_remove();
+    }
+
+private:
+    const std::uint32_t _count_coroutines;
+    F _create_coroutine;
+};
+
+template <typename F> void run_coroutines(const std::uint32_t count_coroutines, F &&create_coroutine)
+{
+    auto core_set = mx::util::core_set{};
+    core_set.emplace_back(0U);
+    mx::tasking::runtime::init(core_set, 0U, false);
+
+    auto *task = mx::tasking::runtime::new_task<SpawnCoroutinesTask<F>>(0U, count_coroutines,
+                                                                        std::forward<F>(create_coroutine));
+    task->annotate(std::uint16_t{0U});
+    mx::tasking::runtime::spawn(*task);
+
+    mx::tasking::runtime::start_and_wait();
+}
+} // namespace
+
+TEST(MxTasking, CoroutinePrefetch)
+{
+    // More coroutines than interleaved by the worker.
+    constexpr auto count_coroutines = 4U * mx::tasking::config::coroutine_interleaving();
+    auto values = std::array<std::uint64_t, 4U>{1U, 2U, 3U, 4U};
+    auto result = std::atomic_uint64_t{0U};
+    auto count_pending = std::atomic_uint32_t{count_coroutines};
+
+    run_coroutines(count_coroutines, [&]() { return sum(values, result, count_pending); });
+
+    EXPECT_EQ(count_pending.load(), 0U);
+    EXPECT_EQ(result.load(), 10U * count_coroutines);
+}
+
+TEST(MxTasking, CoroutineSuspendedAtShutdown)
+{
+    // Coroutines still suspended when the runtime stops are destroyed.
+    constexpr auto count_coroutines = mx::tasking::config::coroutine_interleaving() / 2U;
+    auto value = std::uint64_t{0U};
+    auto count_pending = std::atomic_uint32_t{count_coroutines};
+    auto count_destroyed = std::atomic_uint32_t{0U};
+
+    run_coroutines(count_coroutines, [&]() { return prefetch_forever(value, count_pending, count_destroyed); });
+
+    EXPECT_EQ(count_pending.load(), 0U);
+    EXPECT_EQ(count_destroyed.load(), count_coroutines);
+}
\ No newline at end of file
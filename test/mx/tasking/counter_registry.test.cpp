@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <mx/tasking/profiling/counter_registry.h>
+#include <thread>
+#include <vector>
+
+using namespace mx::tasking::profiling;
+
+TEST(MxTasking, CounterRegistryRegister)
+{
+    auto registry = CounterRegistry{2U};
+    EXPECT_EQ(registry.count_counters(), 0U);
+
+    const auto splits = registry.register_counter("splits");
+    const auto retries = registry.register_counter("retries");
+    EXPECT_NE(splits, retries);
+    EXPECT_EQ(registry.register_counter("splits"), splits);
+    EXPECT_EQ(registry.count_counters(), 2U);
+    EXPECT_EQ(registry.name(retries), "retries");
+    EXPECT_EQ(registry.find("retries"), retries);
+    EXPECT_FALSE(registry.find("hops").has_value());
+}
+
+TEST(MxTasking, CounterRegistryIncrement)
+{
+    auto registry = CounterRegistry{4U};
+    const auto counter = registry.register_counter("counter");
+
+    // Every core owns its block, the shared block is written by all.
+    auto threads = std::vector<std::thread>{};
+    for (auto core_id = std::uint16_t(0U); core_id < 4U; ++core_id)
+    {
+        threads.emplace_back([&registry, counter, core_id] {
+            for (auto i = 0U; i < 10000U; ++i)
+            {
+                registry.increment(core_id, counter);
+                registry.increment_shared(counter, 2U);
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto core_id = std::uint16_t(0U); core_id < 4U; ++core_id)
+    {
+        EXPECT_EQ(registry.get(counter, core_id), 10000U);
+    }
+    EXPECT_EQ(registry.get(counter), 4U * 10000U + 4U * 20000U);
+
+    registry.clear();
+    EXPECT_EQ(registry.get(counter), 0U);
+    EXPECT_EQ(registry.count_counters(), 1U);
+}
\ No newline at end of file
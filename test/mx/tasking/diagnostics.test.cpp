@@ -0,0 +1,39 @@
+#include <csignal>
+#include <gtest/gtest.h>
+#include <mx/tasking/diagnostics.h>
+
+using namespace mx::tasking;
+
+TEST(MxTasking, DiagnosticsEnable)
+{
+    diagnostics::enable_statistics(true);
+    EXPECT_EQ(diagnostics::is_statistics_enabled(), config::task_statistics());
+    diagnostics::enable_statistics(false);
+    EXPECT_FALSE(diagnostics::is_statistics_enabled());
+
+    diagnostics::enable_profiling(false);
+    EXPECT_FALSE(diagnostics::is_profiling_enabled());
+    EXPECT_FALSE(diagnostics::is_task_queue_length_enabled());
+    diagnostics::enable_profiling(true);
+    EXPECT_EQ(diagnostics::is_profiling_enabled(), config::use_tasking_profiler());
+    EXPECT_EQ(diagnostics::is_task_queue_length_enabled(),
+              config::use_tasking_profiler() && config::use_task_queue_length());
+}
+
+TEST(MxTasking, DiagnosticsToggleOnSignal)
+{
+    diagnostics::enable_statistics(false);
+    diagnostics::enable_profiling(false);
+    diagnostics::toggle_on(SIGUSR2);
+
+    std::raise(SIGUSR2);
+    EXPECT_EQ(diagnostics::is_statistics_enabled(), config::task_statistics());
+    EXPECT_EQ(diagnostics::is_profiling_enabled(), config::use_tasking_profiler());
+
+    std::raise(SIGUSR2);
+    EXPECT_FALSE(diagnostics::is_statistics_enabled());
+    EXPECT_FALSE(diagnostics::is_profiling_enabled());
+
+    std::signal(SIGUSR2, SIG_DFL);
+    diagnostics::enable_profiling(true);
+}
\ No newline at end of file
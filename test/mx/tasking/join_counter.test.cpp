@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <mx/tasking/join_counter.h>
+
+namespace {
+class EmptyTask final : public mx::tasking::TaskInterface
+{
+public:
+    constexpr EmptyTask() noexcept = default;
+    ~EmptyTask() override = default;
+
+    mx::tasking::TaskResult execute(std::uint16_t /*core_id*/, std::uint16_t /*channel_id*/) override
+    {
+        return mx::tasking::TaskResult::make_null();
+    }
+};
+} // namespace
+
+TEST(MxTasking, JoinCounter)
+{
+    auto continuation = EmptyTask{};
+    auto join_counter = mx::tasking::JoinCounter{2U, &continuation};
+    EXPECT_EQ(join_counter.pending(), 2U);
+
+    EXPECT_EQ(join_counter.arrive(), nullptr);
+    EXPECT_EQ(join_counter.pending(), 1U);
+    EXPECT_EQ(join_counter.arrive(), &continuation);
+    EXPECT_EQ(join_counter.pending(), 0U);
+}
+
+TEST(MxTasking, JoinCounterAdd)
+{
+    auto continuation = EmptyTask{};
+    auto join_counter = mx::tasking::JoinCounter{1U, &continuation};
+
+    // The predecessor forks two further predecessors before it arrives.
+    join_counter.add(2U);
+    EXPECT_EQ(join_counter.arrive(), nullptr);
+    EXPECT_EQ(join_counter.arrive(), nullptr);
+    EXPECT_EQ(join_counter.arrive(), &continuation);
+
+    join_counter.reset(3U, &continuation);
+    EXPECT_EQ(join_counter.arrive(3U), &continuation);
+}
\ No newline at end of file
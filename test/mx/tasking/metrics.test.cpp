@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <mx/tasking/profiling/idle_profiler.h>
+#include <mx/tasking/profiling/metrics.h>
+
+TEST(MxTasking, LatencyHistogramBuckets)
+{
+    using histogram = mx::tasking::profiling::LatencyHistogram;
+
+    for (auto cycles : {0ULL, 1ULL, 3ULL, 4ULL, 7ULL, 8ULL, 100ULL, 1000ULL, 123456789ULL, ~0ULL})
+    {
+        const auto index = histogram::bucket_index(cycles);
+        EXPECT_LE(cycles, histogram::bucket_upper_bound(index));
+        if (index > 0U)
+        {
+            EXPECT_GT(cycles, histogram::bucket_upper_bound(index - 1U));
+        }
+    }
+}
+
+TEST(MxTasking, LatencyHistogramPercentile)
+{
+    auto histogram = mx::tasking::profiling::LatencyHistogram{};
+    EXPECT_EQ(histogram.percentile(0.5), 0U);
+
+    for (auto i = 0U; i < 99U; ++i)
+    {
+        histogram.record(100U);
+    }
+    histogram.record(10000U);
+    EXPECT_EQ(histogram.count(), 100U);
+
+    // Percentiles are reported as upper bound of the bucket (at most 25% above).
+    EXPECT_GE(histogram.percentile(0.5), 100U);
+    EXPECT_LT(histogram.percentile(0.5), 125U);
+    EXPECT_LT(histogram.percentile(0.99), 125U);
+    EXPECT_GE(histogram.percentile(1.0), 10000U);
+}
+
+TEST(MxTasking, ChannelMetricsQueueDepth)
+{
+    auto metrics = mx::tasking::profiling::ChannelMetrics{};
+    metrics.enqueued_remote(10U);
+    metrics.enqueued_local();
+    metrics.stolen(2U);
+    EXPECT_EQ(metrics.queue_depth(), 13U);
+
+    metrics.executed(100U);
+    metrics.stolen_from(3U);
+    EXPECT_EQ(metrics.queue_depth(), 9U);
+    EXPECT_EQ(metrics.executed(), 1U);
+    EXPECT_EQ(metrics.busy_cycles(), 100U);
+}
+
+TEST(MxTasking, ChannelMetricsIdle)
+{
+    auto metrics = mx::tasking::profiling::ChannelMetrics{};
+    metrics.idled(100U);
+    metrics.idled(300U);
+    EXPECT_EQ(metrics.idle_cycles(), 400U);
+    EXPECT_EQ(metrics.idle().count(), 2U);
+    EXPECT_EQ(metrics.busy_cycles(), 0U);
+}
+
+TEST(MxTasking, IdleRangeLog)
+{
+    auto log = mx::tasking::profiling::IdleRangeLog{2U};
+    log.push(10U, 20U);
+    log.push(30U, 60U);
+    log.push(70U, 80U);
+    EXPECT_EQ(log.size(), 2U);
+    EXPECT_EQ(log.dropped(), 1U);
+    EXPECT_EQ(log[0U].ticks(), 10U);
+    EXPECT_EQ(log[1U].ticks(), 30U);
+
+    // The reset is carried out by the writer at the next push.
+    log.reset();
+    EXPECT_EQ(log.size(), 0U);
+    EXPECT_EQ(log.dropped(), 0U);
+    log.push(90U, 95U);
+    EXPECT_EQ(log.size(), 1U);
+    EXPECT_EQ(log[0U].ticks(), 5U);
+}
+
+TEST(MxTasking, IdleRangeNormalize)
+{
+    // Ranges are normalized to the start of profiling.
+    const auto range = mx::tasking::profiling::IdleRange{100U, 200U};
+    EXPECT_FALSE(range.ends_before(150U));
+    EXPECT_TRUE(range.ends_before(200U));
+    EXPECT_EQ(range.normalize(100U).first, 0U);
+
+    // Ranges started before are cut to the start of profiling.
+    const auto [start, end] = range.normalize(150U);
+    EXPECT_EQ(start, 0U);
+    EXPECT_EQ(end, mx::system::tsc::to_nanoseconds(50U));
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mx/tasking/channel.h>
+#include <mx/tasking/parallel.h>
+#include <mx/tasking/runtime.h>
+#include <mx/util/core_set.h>
+#include <vector>
+
+TEST(MxTasking, ParallelForContext)
+{
+    auto indices = std::vector<std::uint64_t>{};
+    auto is_finished = false;
+    auto context = mx::tasking::ParallelForContext{
+        4U, [&indices](const std::uint64_t index) { indices.emplace_back(index); },
+        [&is_finished]() { is_finished = true; }};
+    EXPECT_EQ(context.grain(), 4U);
+
+    context.execute(2U, 5U, 0U);
+    EXPECT_EQ(indices, (std::vector<std::uint64_t>{2U, 3U, 4U}));
+    EXPECT_EQ(is_finished, false);
+
+    context.finish();
+    EXPECT_EQ(is_finished, true);
+}
+
+TEST(MxTasking, ParallelReduceContext)
+{
+    auto result = std::uint64_t{0U};
+    auto context = mx::tasking::ParallelReduceContext{
+        1U,
+        2U,
+        std::uint64_t{0U},
+        [](const std::uint64_t index) { return index; },
+        [](const std::uint64_t left, const std::uint64_t right) { return left + right; },
+        [&result](const std::uint64_t sum) { result = sum; }};
+
+    // Chunks of both channels are combined on finish.
+    context.execute(0U, 10U, 0U);
+    context.execute(10U, 20U, 1U);
+    context.execute(20U, 21U, 0U);
+    context.finish();
+    EXPECT_EQ(result, 210U);
+}
+
+TEST(MxTasking, ParallelChunkStealable)
+{
+    auto context = mx::tasking::ParallelForContext{4U, [](const std::uint64_t /*index*/) {}, []() {}};
+    auto victim = mx::tasking::Channel{0U, 0U, 0U};
+    auto thief = mx::tasking::Channel{1U, 0U, 0U};
+
+    // Split chunks are published to the remote queues, where idle channels steal them.
+    auto split_chunk = mx::tasking::ParallelChunkTask{context, 0U, 4U};
+    victim.push_back_remote(&split_chunk, 0U);
+    EXPECT_EQ(thief.steal(victim), 1U);
+    EXPECT_EQ(thief.next(), &split_chunk);
+
+    // Chunks dispatched to a channel stay there.
+    auto dispatched_chunk = mx::tasking::ParallelChunkTask{context, 4U, 8U};
+    dispatched_chunk.annotate(std::uint16_t{0U});
+    victim.push_back_remote(&dispatched_chunk, 0U);
+    EXPECT_EQ(thief.steal(victim), 0U);
+}
+
+TEST(MxTasking, ParallelFor)
+{
+    constexpr auto count = 10000U;
+    auto visits = std::make_unique<std::atomic_uint32_t[]>(count);
+    auto is_finished = std::atomic_bool{false};
+
+    auto core_set = mx::util::core_set{};
+    core_set.emplace_back(0U);
+    mx::tasking::runtime::init(core_set, 0U, false);
+
+    // Chunks are split down to the grain and joined before the callback.
+    mx::tasking::runtime::parallel_for(
+        0U, 0U, count, 16U, [&visits](const std::uint64_t index) { visits[index].fetch_add(1U); },
+        [&visits, &is_finished]() {
+            is_finished = std::all_of(visits.get(), visits.get() + count,
+                                      [](const std::atomic_uint32_t &visit) { return visit.load() == 1U; });
+            mx::tasking::runtime::stop();
+        });
+    mx::tasking::runtime::start_and_wait();
+
+    EXPECT_TRUE(is_finished);
+}
+
+TEST(MxTasking, ParallelReduce)
+{
+    constexpr auto count = 10000U;
+    auto result = std::atomic_uint64_t{0U};
+
+    auto core_set = mx::util::core_set{};
+    core_set.emplace_back(0U);
+    mx::tasking::runtime::init(core_set, 0U, false);
+
+    mx::tasking::runtime::parallel_reduce(
+        0U, 0U, count, 16U, std::uint64_t{0U}, [](const std::uint64_t index) { return index; },
+        [](const std::uint64_t left, const std::uint64_t right) { return left + right; },
+        [&result](const std::uint64_t sum) {
+            result = sum;
+            mx::tasking::runtime::stop();
+        });
+    mx::tasking::runtime::start_and_wait();
+
+    EXPECT_EQ(result.load(), std::uint64_t(count) * (count - 1U) / 2U);
+}
\ No newline at end of file
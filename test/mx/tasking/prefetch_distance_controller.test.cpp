@@ -0,0 +1,138 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mx/tasking/prefetch_distance_controller.h>
+
+namespace {
+using controller_t = mx::tasking::PrefetchDistanceController;
+
+/**
+ * Executes tasks, each taking the given number of cycles on a synthetic clock.
+ *
+ * @param controller Controller recording the tasks.
+ * @param timestamp Synthetic clock.
+ * @param count_tasks Number of tasks to execute.
+ * @param cycles_per_task Cycles taken per task.
+ * @return True, if the controller modified the prefetch distance at the last task.
+ */
+bool execute(controller_t &controller, std::uint64_t &timestamp, const std::uint32_t count_tasks,
+             const std::uint64_t cycles_per_task)
+{
+    auto is_modified = false;
+    for (auto i = 0U; i < count_tasks; ++i)
+    {
+        timestamp += cycles_per_task;
+        is_modified = controller.executed([&timestamp] { return timestamp; });
+    }
+
+    return is_modified;
+}
+
+/**
+ * Executes a full epoch of tasks.
+ */
+bool execute_epoch(controller_t &controller, std::uint64_t &timestamp, const std::uint64_t cycles_per_task)
+{
+    return execute(controller, timestamp, controller_t::epoch_size(), cycles_per_task);
+}
+} // namespace
+
+TEST(MxTasking, PrefetchDistanceControllerDisabled)
+{
+    auto controller = controller_t{0U};
+    auto timestamp = std::uint64_t{1U};
+    EXPECT_FALSE(execute(controller, timestamp, 4U * controller_t::epoch_size(), 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 0U);
+}
+
+TEST(MxTasking, PrefetchDistanceControllerEpoch)
+{
+    auto controller = controller_t{4U};
+    auto timestamp = std::uint64_t{1U};
+
+    // The first task starts the epoch, the distance is adapted after a full epoch.
+    EXPECT_FALSE(execute(controller, timestamp, 1U, 100U));
+    EXPECT_FALSE(execute(controller, timestamp, controller_t::epoch_size() - 1U, 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 4U);
+    EXPECT_TRUE(execute(controller, timestamp, 1U, 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 5U);
+}
+
+TEST(MxTasking, PrefetchDistanceControllerHillClimbing)
+{
+    auto controller = controller_t{4U};
+    auto timestamp = std::uint64_t{1U};
+    execute(controller, timestamp, 1U, 0U);
+
+    // Grow while the cycles per task decrease.
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 5U);
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 90U));
+    EXPECT_EQ(controller.prefetch_distance(), 6U);
+
+    // Turn around when the cycles per task increase, and keep shrinking while they decrease.
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 120U));
+    EXPECT_EQ(controller.prefetch_distance(), 5U);
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 110U));
+    EXPECT_EQ(controller.prefetch_distance(), 4U);
+
+    // Equal cycles per task keep the direction.
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 110U));
+    EXPECT_EQ(controller.prefetch_distance(), 3U);
+}
+
+TEST(MxTasking, PrefetchDistanceControllerClamp)
+{
+    // Lower bound.
+    {
+        auto controller = controller_t{2U};
+        auto timestamp = std::uint64_t{1U};
+        execute(controller, timestamp, 1U, 0U);
+
+        EXPECT_TRUE(execute_epoch(controller, timestamp, 100U));
+        EXPECT_EQ(controller.prefetch_distance(), 3U);
+        EXPECT_TRUE(execute_epoch(controller, timestamp, 200U));
+        EXPECT_EQ(controller.prefetch_distance(), 2U);
+        EXPECT_TRUE(execute_epoch(controller, timestamp, 150U));
+        EXPECT_EQ(controller.prefetch_distance(), controller_t::min_prefetch_distance());
+
+        // The bound is kept and the direction flipped.
+        EXPECT_FALSE(execute_epoch(controller, timestamp, 140U));
+        EXPECT_EQ(controller.prefetch_distance(), controller_t::min_prefetch_distance());
+        EXPECT_TRUE(execute_epoch(controller, timestamp, 130U));
+        EXPECT_EQ(controller.prefetch_distance(), controller_t::min_prefetch_distance() + 1U);
+    }
+
+    // Upper bound, half of the task buffer.
+    {
+        EXPECT_EQ(controller_t::max_prefetch_distance(), mx::tasking::config::task_buffer_size() / 2U);
+
+        auto controller = controller_t{controller_t::max_prefetch_distance()};
+        auto timestamp = std::uint64_t{1U};
+        execute(controller, timestamp, 1U, 0U);
+
+        EXPECT_FALSE(execute_epoch(controller, timestamp, 100U));
+        EXPECT_EQ(controller.prefetch_distance(), controller_t::max_prefetch_distance());
+        EXPECT_TRUE(execute_epoch(controller, timestamp, 90U));
+        EXPECT_EQ(controller.prefetch_distance(), controller_t::max_prefetch_distance() - 1U);
+    }
+}
+
+TEST(MxTasking, PrefetchDistanceControllerIdle)
+{
+    auto controller = controller_t{4U};
+    auto timestamp = std::uint64_t{1U};
+    execute(controller, timestamp, 1U, 0U);
+    EXPECT_TRUE(execute_epoch(controller, timestamp, 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 5U);
+
+    // Idling discards the current epoch; the idle time is not measured.
+    EXPECT_FALSE(execute(controller, timestamp, controller_t::epoch_size() / 2U, 100U));
+    controller.idle();
+    timestamp += 1000000000U;
+
+    // The next task starts a new epoch, the tasks before idling are not counted.
+    EXPECT_FALSE(execute(controller, timestamp, 1U, 100U));
+    EXPECT_FALSE(execute(controller, timestamp, controller_t::epoch_size() - 1U, 100U));
+    EXPECT_TRUE(execute(controller, timestamp, 1U, 100U));
+    EXPECT_EQ(controller.prefetch_distance(), 6U);
+}
\ No newline at end of file
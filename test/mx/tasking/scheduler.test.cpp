@@ -0,0 +1,124 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mx/tasking/runtime.h>
+#include <mx/util/core_set.h>
+
+namespace {
+/**
+ * Counts the channels it is executed on; the last task stops the runtime.
+ */
+class CountingTask final : public mx::tasking::TaskInterface
+{
+public:
+    CountingTask(std::atomic_uint32_t &count_pending,
+                 std::array<std::atomic_uint32_t, mx::tasking::config::max_cores()> &count_executed) noexcept
+        : _count_pending(count_pending), _count_executed(count_executed)
+    {
+    }
+    ~CountingTask() override = default;
+
+    mx::tasking::TaskResult execute(const std::uint16_t /*core_id*/, const std::uint16_t channel_id) override
+    {
+        _count_executed[channel_id].fetch_add(1U);
+        if (_count_pending.fetch_sub(1U) == 1U)
+        {
+            return mx::tasking::TaskResult::make_stop();
+        }
+
+        return mx::tasking::TaskResult::make_remove();
+    }
+
+private:
+    std::atomic_uint32_t &_count_pending;
+    std::array<std::atomic_uint32_t, mx::tasking::config::max_cores()> &_count_executed;
+};
+
+/**
+ * Spawns node annotated tasks from within the runtime, directly and batched.
+ */
+class SpawningTask final : public mx::tasking::TaskInterface
+{
+public:
+    SpawningTask(const std::uint32_t count_tasks, const std::uint8_t numa_node_id, std::atomic_uint32_t &count_pending,
+                 std::array<std::atomic_uint32_t, mx::tasking::config::max_cores()> &count_executed) noexcept
+        : _count_tasks(count_tasks), _numa_node_id(numa_node_id), _count_pending(count_pending),
+          _count_executed(count_executed)
+    {
+    }
+    ~SpawningTask() override = default;
+
+    mx::tasking::TaskResult execute(const std::uint16_t core_id, const std::uint16_t channel_id) override
+    {
+        for (auto i = 0U; i < _count_tasks; ++i)
+        {
+            auto *task = mx::tasking::runtime::new_task<CountingTask>(core_id, _count_pending, _count_executed);
+            task->annotate(mx::tasking::TaskInterface::node{_numa_node_id});
+            if (i % 2U == 0U)
+            {
+                mx::tasking::runtime::spawn(*task, channel_id);
+            }
+            else
+            {
+                mx::tasking::runtime::spawn_batch(*task, channel_id);
+            }
+        }
+
+        return mx::tasking::TaskResult::make_remove();
+    }
+
+private:
+    const std::uint32_t _count_tasks;
+    const std::uint8_t _numa_node_id;
+    std::atomic_uint32_t &_count_pending;
+    std::array<std::atomic_uint32_t, mx::tasking::config::max_cores()> &_count_executed;
+};
+
+/**
+ * Runs node annotated tasks, spawned from outside and inside the runtime, on a single channel.
+ *
+ * @param numa_node_id NUMA node annotated to the tasks.
+ * @param count_tasks Number of tasks spawned from outside and inside, each.
+ * @return Number of tasks executed by the channel.
+ */
+std::uint32_t run_node_annotated(const std::uint8_t numa_node_id, const std::uint32_t count_tasks)
+{
+    auto count_executed = std::array<std::atomic_uint32_t, mx::tasking::config::max_cores()>{};
+    auto count_pending = std::atomic_uint32_t{2U * count_tasks};
+
+    auto core_set = mx::util::core_set{};
+    core_set.emplace_back(0U);
+    mx::tasking::runtime::init(core_set, 0U, false);
+
+    for (auto i = 0U; i < count_tasks; ++i)
+    {
+        auto *task = mx::tasking::runtime::new_task<CountingTask>(0U, count_pending, count_executed);
+        task->annotate(mx::tasking::TaskInterface::node{numa_node_id});
+        mx::tasking::runtime::spawn(*task);
+    }
+
+    auto *spawning_task =
+        mx::tasking::runtime::new_task<SpawningTask>(0U, count_tasks, numa_node_id, count_pending, count_executed);
+    spawning_task->annotate(std::uint16_t{0U});
+    mx::tasking::runtime::spawn(*spawning_task);
+
+    mx::tasking::runtime::start_and_wait();
+    EXPECT_EQ(count_pending.load(), 0U);
+
+    return count_executed[0U].load();
+}
+} // namespace
+
+TEST(MxTasking, SchedulerNodeAnnotated)
+{
+    EXPECT_EQ(run_node_annotated(mx::system::topology::node_id(0U), 64U), 128U);
+}
+
+TEST(MxTasking, SchedulerNodeAnnotatedWithoutChannel)
+{
+    // Regions without channels fall back to the region of the first channel.
+    const auto numa_node_id = std::uint8_t((mx::system::topology::node_id(0U) + 1U) %
+                                           mx::memory::config::max_numa_nodes());
+    EXPECT_EQ(run_node_annotated(numa_node_id, 64U), 128U);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <mx/tasking/profiling/statistic.h>
+#include <typeinfo>
+
+namespace {
+struct FirstTaskType
+{
+};
+struct SecondTaskType
+{
+};
+} // namespace
+
+TEST(MxTasking, StatisticTaskLatencies)
+{
+    auto statistic = mx::tasking::profiling::Statistic{2U};
+    EXPECT_TRUE(statistic.latencies().empty());
+
+    for (auto i = 0U; i < 100U; ++i)
+    {
+        statistic.record_latency(0U, typeid(FirstTaskType), 1000U, 100U);
+        statistic.record_latency(1U, typeid(FirstTaskType), 1000U, 100000U);
+    }
+    statistic.record_latency(1U, typeid(SecondTaskType), 0U, 100U);
+    statistic.record_failed_validations(0U, typeid(FirstTaskType), 3U);
+    statistic.record_failed_validations(1U, typeid(FirstTaskType), 2U);
+
+    // Types are merged over all channels.
+    const auto latencies = statistic.latencies();
+    ASSERT_EQ(latencies.size(), 2U);
+
+    const auto first = std::find_if(latencies.begin(), latencies.end(), [](const auto &latency) {
+        return latency.name.find("FirstTaskType") != std::string::npos;
+    });
+    ASSERT_NE(first, latencies.end());
+    EXPECT_EQ(first->count, 200U);
+    EXPECT_GT(first->execution[3U], first->execution[0U]);
+    EXPECT_EQ(first->queueing[0U], first->queueing[3U]);
+    EXPECT_EQ(first->failed_validations, 5U);
+
+    // Unknown queueing time is not recorded.
+    const auto second = std::find_if(latencies.begin(), latencies.end(), [](const auto &latency) {
+        return latency.name.find("SecondTaskType") != std::string::npos;
+    });
+    ASSERT_NE(second, latencies.end());
+    EXPECT_EQ(second->count, 1U);
+    EXPECT_EQ(second->queueing[0U], 0U);
+    EXPECT_EQ(second->failed_validations, 0U);
+
+    statistic.clear();
+    EXPECT_TRUE(statistic.latencies().empty());
+}
+
+TEST(MxTasking, StatisticPerfCounters)
+{
+    using PerfCounters = mx::tasking::profiling::PerfCounters;
+
+    auto statistic = mx::tasking::profiling::Statistic{2U};
+    statistic.record_perf_counters(0U, typeid(FirstTaskType), PerfCounters::values_t{100U, 200U, 3U, 1U, 50U});
+    statistic.record_perf_counters(1U, typeid(FirstTaskType), PerfCounters::values_t{100U, 300U, 5U, 2U, 70U});
+    statistic.record_perf_counters(1U, typeid(SecondTaskType), PerfCounters::values_t{10U, 10U, 0U, 0U, 0U});
+
+    // Counters are summed per channel and merged per type.
+    EXPECT_EQ(statistic.perf_counters(1U)[PerfCounters::Cycles], 310U);
+    const auto latencies = statistic.latencies();
+    const auto first = std::find_if(latencies.begin(), latencies.end(), [](const auto &latency) {
+        return latency.name.find("FirstTaskType") != std::string::npos;
+    });
+    ASSERT_NE(first, latencies.end());
+    EXPECT_EQ(first->perf_counters[PerfCounters::Instructions], 200U);
+    EXPECT_EQ(first->perf_counters[PerfCounters::LLCMisses], 3U);
+
+    statistic.clear();
+    EXPECT_EQ(statistic.perf_counters(1U)[PerfCounters::Cycles], 0U);
+}
+
+TEST(MxTasking, PerfCountersOpen)
+{
+    // The kernel may deny access to counters; reading unopened counters yields zero.
+    auto perf_counters = mx::tasking::profiling::PerfCounters{};
+    auto values = mx::tasking::profiling::PerfCounters::values_t{};
+    if (perf_counters.open())
+    {
+        perf_counters.read(values);
+        EXPECT_GT(values[mx::tasking::profiling::PerfCounters::Instructions], 0U);
+        perf_counters.close();
+    }
+    EXPECT_FALSE(perf_counters.is_open());
+
+    perf_counters.read(values);
+    EXPECT_EQ(values[mx::tasking::profiling::PerfCounters::Instructions], 0U);
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <mx/tasking/profiling/tasking_profiler.h>
+#include <string>
+
+namespace {
+/**
+ * Starts and ends tasks on the first core.
+ *
+ * @param profiler Profiler recording the tasks.
+ * @param count_tasks Number of tasks.
+ * @param name Name of the tasks.
+ * @return Number of tasks sampled by the profiler.
+ */
+std::uint32_t run_tasks(TaskingProfiler &profiler, const std::uint32_t count_tasks, const char *name)
+{
+    auto count_sampled = 0U;
+    for (auto i = 0U; i < count_tasks; ++i)
+    {
+        const auto id = profiler.startTask(0U, 0U, name);
+        count_sampled += id != 0U;
+        profiler.endTask(0U, id);
+    }
+
+    return count_sampled;
+}
+
+/**
+ * @param profiler Profiler with saved profile.
+ * @param name Name of the tasks.
+ * @return Number of recorded tasks with the given name.
+ */
+std::uint64_t count_recorded(const TaskingProfiler &profiler, const char *name)
+{
+    for (const auto &task_type : profiler.taskTypes())
+    {
+        if (std::strcmp(task_type.name, name) == 0)
+        {
+            return task_type.count;
+        }
+    }
+
+    return 0U;
+}
+} // namespace
+
+TEST(MxTasking, TaskingProfilerSampling)
+{
+    const auto file_name = std::string{::testing::TempDir() + "mxtasking_profiler.test"};
+    auto &profiler = TaskingProfiler::getInstance();
+    profiler.init(0U, file_name);
+
+    // Every n-th task of a core is recorded.
+    profiler.sample(4U);
+    EXPECT_TRUE(profiler.isSampling());
+    EXPECT_EQ(run_tasks(profiler, 1000U, "every_4th"), 250U);
+
+    // Ending a task that was not sampled does not end the sampled task started before.
+    const auto id = profiler.startTask(0U, 0U, "nested");
+    ASSERT_NE(id, 0U);
+    EXPECT_EQ(run_tasks(profiler, 3U, "unsampled"), 0U);
+    profiler.endTask(0U, id);
+
+    // Tasks within the interval are not recorded.
+    profiler.sample(1U, 1000000000U);
+    EXPECT_TRUE(profiler.isSampling());
+    EXPECT_LE(run_tasks(profiler, 1000U, "interval"), 2U);
+
+    profiler.sample(1U);
+    EXPECT_FALSE(profiler.isSampling());
+    EXPECT_EQ(run_tasks(profiler, 10U, "every"), 10U);
+
+    profiler.saveProfile();
+    EXPECT_EQ(count_recorded(profiler, "every_4th"), 250U);
+    EXPECT_EQ(count_recorded(profiler, "nested"), 1U);
+    EXPECT_EQ(count_recorded(profiler, "unsampled"), 0U);
+    EXPECT_EQ(count_recorded(profiler, "every"), 10U);
+
+    std::remove(file_name.c_str());
+}
\ No newline at end of file
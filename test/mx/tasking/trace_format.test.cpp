@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <limits>
+#include <mx/tasking/profiling/trace_format.h>
+#include <string>
+
+using namespace mx::tasking::profiling;
+
+TEST(MxTasking, TraceZigzag)
+{
+    for (const auto value : {std::int64_t{0}, std::int64_t{1}, std::int64_t{-1}, std::int64_t{1000000},
+                             std::int64_t{-1000000}, std::numeric_limits<std::int64_t>::max(),
+                             std::numeric_limits<std::int64_t>::min()})
+    {
+        EXPECT_EQ(trace::zigzag_decode(trace::zigzag_encode(value)), value);
+    }
+    EXPECT_EQ(trace::zigzag_encode(-1), 1U);
+    EXPECT_EQ(trace::zigzag_encode(1), 2U);
+}
+
+TEST(MxTasking, TraceWriteRead)
+{
+    const auto file_name = std::string{::testing::TempDir() + "mxtasking_trace.test"};
+
+    {
+        auto writer = trace::Writer{};
+        ASSERT_TRUE(writer.open(file_name, 4U));
+        writer.write_tag(trace::Name);
+        writer.write_varint(0U);
+        writer.write_varint(4U);
+        writer.write("Task", 4U);
+
+        // More events than fit into the buffer.
+        for (auto i = 0U; i < 100000U; ++i)
+        {
+            writer.write_tag(trace::Enqueue);
+            writer.write_varint(std::uint64_t(i) << 20U);
+        }
+    }
+
+    auto reader = trace::Reader{};
+    ASSERT_TRUE(reader.open(file_name));
+    EXPECT_EQ(reader.count_cores(), 4U);
+
+    auto tag = trace::Tag{};
+    auto value = std::uint64_t{0U};
+    auto name = std::string{};
+    ASSERT_TRUE(reader.read_tag(tag));
+    EXPECT_EQ(tag, trace::Name);
+    EXPECT_TRUE(reader.read_varint(value));
+    EXPECT_EQ(value, 0U);
+    EXPECT_TRUE(reader.read_varint(value));
+    EXPECT_EQ(value, 4U);
+    EXPECT_TRUE(reader.read(name, value));
+    EXPECT_EQ(name, "Task");
+
+    for (auto i = 0U; i < 100000U; ++i)
+    {
+        ASSERT_TRUE(reader.read_tag(tag));
+        EXPECT_EQ(tag, trace::Enqueue);
+        ASSERT_TRUE(reader.read_varint(value));
+        EXPECT_EQ(value, std::uint64_t(i) << 20U);
+    }
+    EXPECT_FALSE(reader.read_tag(tag));
+
+    std::remove(file_name.c_str());
+}
\ No newline at end of file
@@ -14,4 +14,22 @@ TEST(MxTasking, MPSCQueue)
     EXPECT_EQ(&queue_item, pulled_item);
     EXPECT_EQ(queue.empty(), true);
     EXPECT_EQ(queue.pop_front(), nullptr);
-}
\ No newline at end of file
+}
+
+TEST(MxTasking, MPSCQueueFront)
+{
+    auto queue = mx::util::MPSCQueue<mx::util::QueueItem>{};
+    EXPECT_EQ(queue.front(), nullptr);
+
+    auto first_item = mx::util::QueueItem{};
+    auto second_item = mx::util::QueueItem{};
+    queue.push_back(&first_item);
+    queue.push_back(&second_item);
+    EXPECT_EQ(queue.front(), &first_item);
+    EXPECT_EQ(queue.front(), &first_item);
+    EXPECT_EQ(queue.pop_front(), &first_item);
+    EXPECT_EQ(queue.front(), &second_item);
+    EXPECT_EQ(queue.pop_front(), &second_item);
+    EXPECT_EQ(queue.front(), nullptr);
+    EXPECT_EQ(queue.empty(), true);
+}
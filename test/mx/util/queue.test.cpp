@@ -14,4 +14,21 @@ TEST(MxTasking, Queue)
     EXPECT_EQ(&queue_item, pulled_item);
     EXPECT_EQ(queue.empty(), true);
     EXPECT_EQ(queue.pop_front(), nullptr);
+}
+
+TEST(MxTasking, QueueClear)
+{
+    auto queue = mx::util::Queue<mx::util::QueueItem>{};
+
+    auto first_item = mx::util::QueueItem{};
+    auto second_item = mx::util::QueueItem{};
+    queue.push_back(&first_item);
+    queue.push_back(&second_item);
+    EXPECT_EQ(queue.begin(), &first_item);
+    EXPECT_EQ(queue.end(), &second_item);
+    EXPECT_EQ(first_item.next(), &second_item);
+
+    queue.clear();
+    EXPECT_EQ(queue.empty(), true);
+    EXPECT_EQ(queue.pop_front(), nullptr);
 }
\ No newline at end of file